@@ -0,0 +1,97 @@
+#include "lib/Row.h"
+#include "lib/iterators/AdaptiveGroupBy.h"
+#include "lib/iterators/InSortGroupBy.h"
+#include "lib/iterators/VectorScan.h"
+#include "lib/iterators/AssertEqual.h"
+#include "lib/iterators/AssertCorrectOVC.h"
+#include "lib/iterators/AssertSorted.h"
+#include "lib/log.h"
+#include "lib/iterators/Sort.h"
+#include "lib/iterators/RowGenerator.h"
+
+#include <gtest/gtest.h>
+
+using namespace ovc;
+using namespace iterators;
+
+class AdaptiveGroupByTest : public ::testing::Test {
+protected:
+    const size_t SEED = 1337;
+    const size_t WORKSPACE_ROWS = QUEUE_CAPACITY * ((1 << RUN_IDX_BITS) - 3);
+
+    void SetUp() override {
+        log_set_quiet(true);
+        log_set_level(LOG_ERROR);
+    }
+
+    void TearDown() override {
+    }
+
+    /**
+     * Compare against InSortGroupBy, both sides are sorted on all columns since hashing loses the order.
+     */
+    void testAdaptive(size_t num_rows, std::initializer_list<uint8_t> bits, bool sorted_output,
+                      GroupByStrategy expected) {
+        int group_columns = (int) bits.size();
+        auto *adaptive = new AdaptiveGroupByOVC(
+                new RowGenerator(num_rows, bits, SEED), group_columns, sorted_output, aggregates::Count(group_columns));
+        auto *plan = new AssertEqual(
+                new Sort(adaptive),
+                new Sort(new InSortGroupByOVC(new RowGenerator(num_rows, bits, SEED), group_columns,
+                                              aggregates::Count(group_columns))));
+        plan->run();
+        ASSERT_TRUE(plan->isEqual());
+        ASSERT_EQ(adaptive->getStrategy(), expected);
+        delete plan;
+    }
+};
+
+TEST_F(AdaptiveGroupByTest, EmptyTest) {
+    auto *adaptive = new AdaptiveGroupByOVC(new RowGenerator(0, 0, 0), 1, false, aggregates::Count(1));
+    auto *plan = new AssertEqual(adaptive, new VectorScan({}));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    ASSERT_EQ(adaptive->getStrategy(), IN_SORT);
+    delete plan;
+}
+
+TEST_F(AdaptiveGroupByTest, SmallInputStaysInSort) {
+    testAdaptive(1000, {10, 10, 10}, false, IN_SORT);
+}
+
+TEST_F(AdaptiveGroupByTest, FewGroupsStayInSort) {
+    testAdaptive(WORKSPACE_ROWS * 3, {4, 4}, false, IN_SORT);
+}
+
+TEST_F(AdaptiveGroupByTest, ManyGroupsSwitchToHash) {
+    testAdaptive(WORKSPACE_ROWS * 3, {10, 10, 10}, false, HASH);
+}
+
+TEST_F(AdaptiveGroupByTest, ManyGroupsSortedOutput) {
+    testAdaptive(WORKSPACE_ROWS * 3, {10, 10, 10}, true, IN_SORT);
+}
+
+TEST_F(AdaptiveGroupByTest, SortedOutputHasOVCs) {
+    size_t num_rows = WORKSPACE_ROWS * 2;
+    auto *correct = new AssertCorrectOVC(
+            new AdaptiveGroupByOVC(new RowGenerator(num_rows, {10, 10, 10}, SEED), 2, true,
+                                   aggregates::Count(2)), 2);
+    auto *plan = new AssertSorted(correct);
+    plan->run();
+    ASSERT_TRUE(plan->isSorted());
+    ASSERT_TRUE(correct->isCorrect());
+    delete plan;
+}
+
+TEST_F(AdaptiveGroupByTest, NoOVC) {
+    size_t num_rows = WORKSPACE_ROWS * 3;
+    auto *adaptive = new AdaptiveGroupBy(new RowGenerator(num_rows, {10, 10, 10}, SEED), 3, false,
+                                         aggregates::Count(3));
+    auto *plan = new AssertEqual(
+            new Sort(adaptive),
+            new Sort(new InSortGroupBy(new RowGenerator(num_rows, {10, 10, 10}, SEED), 3, aggregates::Count(3))));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    ASSERT_EQ(adaptive->getStrategy(), HASH);
+    delete plan;
+}
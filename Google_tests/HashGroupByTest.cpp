@@ -1,5 +1,6 @@
 #include "lib/Row.h"
 #include "lib/iterators/HashGroupBy.h"
+#include "lib/iterators/InSortGroupBy.h"
 #include "lib/iterators/VectorScan.h"
 #include "lib/iterators/AssertEqual.h"
 #include "lib/log.h"
@@ -107,4 +108,61 @@ TEST_F(HashGroupByTest, DoesntLoseRows2) {
     plan->close();
     ASSERT_EQ(count, num_rows);
     delete plan;
-}
\ No newline at end of file
+}
+
+TEST_F(HashGroupByTest, MultipleAggregates) {
+    auto *plan = new AssertEqual(new SortOVC(
+            new HashGroupBy(
+                    new VectorScan({
+                                           {0, 0, {0, 3, 5}},
+                                           {0, 1, {0, 4, 2}},
+                                           {0, 2, {1, 1, 7}},
+                                           {0, 3, {1, 2, 1}},
+                                           {0, 4, {1, 6, 4}},
+                                           {0, 5, {2, 5, 9}},
+                                   }), 1,
+                    aggregates::Aggregates<aggregates::fused::Sum<1>, aggregates::fused::Min<2>,
+                            aggregates::fused::Max<2>, aggregates::fused::Count>(1))),
+            new VectorScan({
+                                   {0, 0, {0, 7, 2, 5, 2}},
+                                   {0, 0, {1, 9, 1, 7, 3}},
+                                   {0, 0, {2, 5, 9, 9, 1}},
+                           })
+    );
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(HashGroupByTest, MultipleAggregatesDoesntLoseRows) {
+    unsigned num_rows = 100000;
+    int group_columns = 2;
+
+    auto *plan = new HashGroupBy(new RowGenerator(num_rows, 32), group_columns,
+                                 aggregates::Aggregates<aggregates::fused::Max<3>, aggregates::fused::Count>(
+                                         group_columns));
+    plan->open();
+    unsigned count = 0;
+    for (Row *row; (row = plan->next()); plan->free()) {
+        ASSERT_LT(row->columns[group_columns], 32);
+        count += row->columns[group_columns + 1];
+    }
+    plan->close();
+    ASSERT_EQ(count, num_rows);
+    delete plan;
+}
+
+TEST_F(HashGroupByTest, ColumnList) {
+    unsigned num_rows = 100000;
+    uint8_t columns[] = {2, 0};
+    typedef aggregates::AggregatesAt<aggregates::fused::Sum<3>, aggregates::fused::Count> Agg;
+    auto *plan = new AssertEqual(
+            new SortBase<false, CmpColumnList>(
+                    new HashGroupBy(new RowGenerator(num_rows, {5, 0, 5, 8}, 3), columns, 2, Agg(3)),
+                    CmpColumnList(columns, 2)),
+            new InSortGroupByColumnList(new RowGenerator(num_rows, {5, 0, 5, 8}, 3), columns, 2, Agg(3))
+    );
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
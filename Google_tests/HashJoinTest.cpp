@@ -0,0 +1,210 @@
+#include "lib/iterators/HashJoin.h"
+#include "lib/iterators/MergeJoin.h"
+#include "lib/iterators/Sort.h"
+#include "lib/iterators/VectorScan.h"
+#include "lib/iterators/AssertEqual.h"
+#include "lib/iterators/GeneratorWithDomains.h"
+#include "lib/log.h"
+
+#include <gtest/gtest.h>
+#include <unordered_set>
+
+using namespace ovc;
+using namespace iterators;
+
+class HashJoinTest : public ::testing::Test {
+protected:
+
+    const size_t SEED = 1337;
+
+    void SetUp() override {
+        log_set_quiet(true);
+        log_set_level(LOG_ERROR);
+    }
+
+    void TearDown() override {
+
+    }
+
+    static Iterator *leftInput() {
+        return new VectorScan({{0, 0, {4, 40}},
+                               {0, 0, {2, 21}},
+                               {0, 0, {1, 10}},
+                               {0, 0, {5, 50}},
+                               {0, 0, {2, 20}}});
+    }
+
+    static Iterator *rightInput() {
+        return new VectorScan({{0, 0, {3, 102}},
+                               {0, 0, {2, 101}},
+                               {0, 0, {4, 103}},
+                               {0, 0, {2, 100}}});
+    }
+
+    /**
+     * Compare the number of output rows against the corresponding merge join.
+     */
+    template<typename MergeJoin, typename HashJoin>
+    void testJoin(size_t left_rows, size_t right_rows, int upper, int join_columns, size_t memory_rows) {
+        auto gen_left = GeneratorWithDomains(left_rows, upper, 0, SEED);
+        auto gen_right = GeneratorWithDomains(right_rows, upper, 0, SEED + 1);
+
+        auto merge = MergeJoin(new SortPrefix(gen_left.clone(), join_columns),
+                               new SortPrefix(gen_right.clone(), join_columns), join_columns);
+        merge.run();
+
+        auto hash = HashJoin(gen_left.clone(), gen_right.clone(), join_columns, memory_rows);
+        hash.run();
+
+        ASSERT_GT(merge.getCount(), 0);
+        ASSERT_EQ(hash.getCount(), merge.getCount());
+        if (right_rows <= memory_rows) {
+            ASSERT_EQ(hash.getSpilledPartitions(), 0);
+        } else {
+            ASSERT_GT(hash.getSpilledPartitions(), 0);
+        }
+    }
+};
+
+class InnerHashJoinMem : public InnerHashJoin {
+public:
+    InnerHashJoinMem(Iterator *left, Iterator *right, unsigned join_columns, size_t memory_rows)
+            : InnerHashJoin(left, right, join_columns, ROW_ARITY / 2, ROW_ARITY / 2, memory_rows) {}
+};
+
+class LeftOuterHashJoinMem : public LeftOuterHashJoin {
+public:
+    LeftOuterHashJoinMem(Iterator *left, Iterator *right, unsigned join_columns, size_t memory_rows)
+            : LeftOuterHashJoin(left, right, join_columns, ROW_ARITY / 2, ROW_ARITY / 2, memory_rows) {}
+};
+
+TEST_F(HashJoinTest, InnerEmpty) {
+    auto *plan = new AssertEqual(
+            new InnerHashJoin(new VectorScan({}), rightInput(), 1, 2, 2),
+            new VectorScan({}));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(HashJoinTest, InnerSmall) {
+    auto *plan = new AssertEqual(
+            new SortPrefix(new InnerHashJoin(leftInput(), rightInput(), 1, 2, 2), 3),
+            new VectorScan({{0, 0, {2, 20, 100}},
+                            {0, 0, {2, 20, 101}},
+                            {0, 0, {2, 21, 100}},
+                            {0, 0, {2, 21, 101}},
+                            {0, 0, {4, 40, 103}}}));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(HashJoinTest, InnerSmallSpilled) {
+    auto *plan = new AssertEqual(
+            new SortPrefix(new InnerHashJoin(leftInput(), rightInput(), 1, 2, 2, 0), 3),
+            new VectorScan({{0, 0, {2, 20, 100}},
+                            {0, 0, {2, 20, 101}},
+                            {0, 0, {2, 21, 100}},
+                            {0, 0, {2, 21, 101}},
+                            {0, 0, {4, 40, 103}}}));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(HashJoinTest, LeftOuterSmall) {
+    auto *plan = new AssertEqual(
+            new SortPrefix(new LeftOuterHashJoin(leftInput(), rightInput(), 1, 2, 2), 3),
+            new VectorScan({{0, 0, {1, 10, 0}},
+                            {0, 0, {2, 20, 100}},
+                            {0, 0, {2, 20, 101}},
+                            {0, 0, {2, 21, 100}},
+                            {0, 0, {2, 21, 101}},
+                            {0, 0, {4, 40, 103}},
+                            {0, 0, {5, 50, 0}}}));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(HashJoinTest, LeftAntiSmall) {
+    auto *plan = new AssertEqual(
+            new SortPrefix(new LeftAntiHashJoin(leftInput(), rightInput(), 1), 2),
+            new VectorScan({{0, 0, {1, 10}},
+                            {0, 0, {5, 50}}}));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(HashJoinTest, Projection) {
+    // output the right payload followed by the left payload
+    auto project = [](Row &out, const Row *left, const Row *right) {
+        out = Row();
+        out.columns[0] = right->columns[1];
+        out.columns[1] = left->columns[1];
+    };
+    auto *plan = new AssertEqual(
+            new SortPrefix(new HashJoinBase<INNER_JOIN, decltype(project)>(leftInput(), rightInput(), 1, project), 2),
+            new VectorScan({{0, 0, {100, 20}},
+                            {0, 0, {100, 21}},
+                            {0, 0, {101, 20}},
+                            {0, 0, {101, 21}},
+                            {0, 0, {103, 40}}}));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(HashJoinTest, InnerInMemory) {
+    testJoin<InnerJoin, InnerHashJoinMem>(10000, 10000, 8, 4, HASH_JOIN_MEMORY_ROWS);
+}
+
+TEST_F(HashJoinTest, InnerHybrid) {
+    testJoin<InnerJoin, InnerHashJoinMem>(10000, 10000, 8, 4, 2000);
+}
+
+TEST_F(HashJoinTest, InnerGrace) {
+    testJoin<InnerJoin, InnerHashJoinMem>(20000, 50000, 16, 4, 100);
+}
+
+TEST_F(HashJoinTest, LeftOuterHybrid) {
+    testJoin<LeftOuterJoin, LeftOuterHashJoinMem>(10000, 10000, 8, 4, 2000);
+}
+
+TEST_F(HashJoinTest, LeftAntiHybrid) {
+    testJoin<LeftAntiJoin, LeftAntiHashJoin>(10000, 10000, 8, 4, 2000);
+}
+
+TEST_F(HashJoinTest, LeftAntiGrace) {
+    testJoin<LeftAntiJoin, LeftAntiHashJoin>(20000, 50000, 16, 4, 100);
+}
+
+TEST_F(HashJoinTest, BloomFilterLargeBuildSide) {
+    // the spilled build side is many times larger than memory, the filter must still drop left rows without partner
+    std::vector<Row> left_rows;
+    for (unsigned long i = 0; i < 10000; i++) {
+        left_rows.push_back({0, 0, {100 + i % 64, i % 7, i % 5, i % 3}});
+    }
+    auto right_rows = GeneratorWithDomains(50000, 16, 0, SEED).collect();
+
+    // every partition that receives right rows exceeds the memory and is spilled
+    std::unordered_set<unsigned long> spilled;
+    for (auto row: right_rows) {
+        row.setHash(4);
+        spilled.insert(row.key % HASH_JOIN_PARTITIONS);
+    }
+    size_t spilled_left_rows = 0;
+    for (auto row: left_rows) {
+        row.setHash(4);
+        spilled_left_rows += spilled.count(row.key % HASH_JOIN_PARTITIONS);
+    }
+
+    auto hash = InnerHashJoinMem(new VectorScan(left_rows), new VectorScan(right_rows), 4, 100);
+    hash.run();
+    ASSERT_EQ(hash.getCount(), 0);
+    ASSERT_EQ(hash.getSpilledPartitions(), spilled.size());
+    ASSERT_GT(spilled_left_rows, 0);
+    ASSERT_GE(hash.getFiltered(), spilled_left_rows * 99 / 100);
+}
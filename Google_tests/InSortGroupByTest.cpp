@@ -191,4 +191,96 @@ TEST_F(InSortGroupByTest, DoesntLoseRows2) {
     plan->close();
     ASSERT_EQ(count, num_rows);
     delete plan;
-}
\ No newline at end of file
+}
+
+TEST_F(InSortGroupByTest, OVCMultipleAggregates) {
+    auto *plan = new AssertEqual(
+            new InSortGroupByOVC(
+                    new VectorScan({
+                                           {0, 0, {0, 3, 5}},
+                                           {0, 1, {0, 4, 2}},
+                                           {0, 2, {1, 1, 7}},
+                                           {0, 3, {1, 2, 1}},
+                                           {0, 4, {1, 6, 4}},
+                                           {0, 5, {2, 5, 9}},
+                                   }), 1,
+                    aggregates::Aggregates<aggregates::fused::Sum<1>, aggregates::fused::Min<2>,
+                            aggregates::fused::Max<2>, aggregates::fused::Count>(1)),
+            new VectorScan({
+                                   {0, 0, {0, 7, 2, 5, 2}},
+                                   {0, 0, {1, 9, 1, 7, 3}},
+                                   {0, 0, {2, 5, 9, 9, 1}},
+                           })
+    );
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(InSortGroupByTest, OVCAggregateInQueue) {
+    unsigned num_rows = 100000;
+    int group_columns = 2;
+
+    auto *in_queue = new InSortGroupByOVC(new RowGenerator(num_rows, {6, 6, 8}, 7), group_columns,
+                                          aggregates::Sum(group_columns, group_columns), true);
+    auto *plan = new AssertEqual(
+            in_queue,
+            new InSortGroupByOVC(new RowGenerator(num_rows, {6, 6, 8}, 7), group_columns,
+                                 aggregates::Sum(group_columns, group_columns)));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    ASSERT_GT(in_queue->getQueueMerges(), 0);
+    delete plan;
+}
+
+TEST_F(InSortGroupByTest, AggregateInQueue) {
+    unsigned num_rows = 100000;
+    int group_columns = 2;
+
+    auto *in_queue = new InSortGroupBy(new RowGenerator(num_rows, {6, 6}, 7), group_columns,
+                                       aggregates::Count(group_columns), true);
+    in_queue->open();
+    unsigned count = 0;
+    for (Row *row; (row = in_queue->next()); in_queue->free()) {
+        count += row->columns[group_columns];
+    }
+    in_queue->close();
+    ASSERT_EQ(count, num_rows);
+    ASSERT_GT(in_queue->getQueueMerges(), 0);
+    delete in_queue;
+}
+
+TEST_F(InSortGroupByTest, OVCHeavyHitters) {
+    unsigned num_rows = QUEUE_CAPACITY * ((1 << RUN_IDX_BITS) - 3) * 4;
+    int group_columns = 2;
+
+    auto *heavy = new InSortGroupByOVC(new RowGenerator(num_rows, {6, 6, 8}, 7), group_columns,
+                                       aggregates::Sum(group_columns, group_columns));
+    heavy->trackHeavyHitters();
+    auto *plan = new AssertEqual(
+            heavy,
+            new InSortGroupByOVC(new RowGenerator(num_rows, {6, 6, 8}, 7), group_columns,
+                                 aggregates::Sum(group_columns, group_columns)));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    ASSERT_GT(heavy->getHeavyHitterHits(), 0);
+    delete plan;
+}
+
+TEST_F(InSortGroupByTest, HeavyHitters) {
+    unsigned num_rows = QUEUE_CAPACITY * ((1 << RUN_IDX_BITS) - 3) * 4;
+    int group_columns = 2;
+
+    auto *heavy = new InSortGroupBy(new RowGenerator(num_rows, {6, 6}, 7), group_columns,
+                                    aggregates::Count(group_columns));
+    heavy->trackHeavyHitters();
+    heavy->open();
+    unsigned count = 0;
+    for (Row *row; (row = heavy->next()); heavy->free()) {
+        count += row->columns[group_columns];
+    }
+    heavy->close();
+    ASSERT_EQ(count, num_rows);
+    ASSERT_GT(heavy->getHeavyHitterHits(), 0);
+    delete heavy;
+}
@@ -6,6 +6,9 @@
 #include "lib/iterators/AssertSortedUnique.h"
 #include "lib/iterators/InStreamDistinct.h"
 #include "lib/iterators/GeneratorWithDomains.h"
+#include "lib/iterators/AssertCorrectOVC.h"
+#include "lib/iterators/AssertEqual.h"
+#include "lib/iterators/RowGenerator.h"
 
 #include <gtest/gtest.h>
 
@@ -50,6 +53,26 @@ protected:
         ASSERT_TRUE(plan->isSortedAndUnique());
         delete plan;
     }
+
+    void testInStreamDistinctPrefixOVC(size_t num_rows, int prefix) {
+        auto *distinct = new InStreamDistinctPrefixOVC(
+                new SortOVC(
+                        new RowGenerator(num_rows, {4, 4, 4, 8}, SEED)), prefix);
+        auto *correct = new AssertCorrectOVC(distinct, prefix);
+        auto *plan = new AssertEqual(
+                correct,
+                new InStreamDistinctPrefix(
+                        new Sort(
+                                new RowGenerator(num_rows, {4, 4, 4, 8}, SEED)), prefix));
+        plan->run();
+        ASSERT_TRUE(plan->isEqual());
+        ASSERT_TRUE(correct->isCorrect());
+        if (num_rows > 0) {
+            ASSERT_TRUE(plan->getCount() > 0);
+        }
+        ASSERT_EQ(plan->getCount() + distinct->num_dupes, num_rows);
+        delete plan;
+    }
 };
 
 TEST_F(InStreamDistinctTest, EmptyTest) {
@@ -180,4 +203,19 @@ TEST_F(InStreamDistinctTest, DistinctMediumButABitLarger2) {
 //
 //TEST_F(InStreamDistinctTest, DistinctLarge) {
 //    testInStreamDistinct(QUEUE_SIZE * INITIAL_RUNS * 8);
-//}
\ No newline at end of file
+//}
+TEST_F(InStreamDistinctTest, DistinctPrefixOVCTiny) {
+    testInStreamDistinctPrefixOVC(5, 2);
+}
+
+TEST_F(InStreamDistinctTest, DistinctPrefixOVCOneColumn) {
+    testInStreamDistinctPrefixOVC(QUEUE_SIZE * 3, 1);
+}
+
+TEST_F(InStreamDistinctTest, DistinctPrefixOVCTwoColumns) {
+    testInStreamDistinctPrefixOVC(QUEUE_SIZE * 3, 2);
+}
+
+TEST_F(InStreamDistinctTest, DistinctPrefixOVCThreeColumns) {
+    testInStreamDistinctPrefixOVC(QUEUE_SIZE * INITIAL_RUNS, 3);
+}
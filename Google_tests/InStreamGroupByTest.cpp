@@ -5,6 +5,7 @@
 #include "lib/log.h"
 #include "lib/iterators/Sort.h"
 #include "lib/iterators/RowGenerator.h"
+#include "lib/iterators/InSortGroupBy.h"
 
 #include <gtest/gtest.h>
 
@@ -204,4 +205,205 @@ TEST_F(InStreamGroupByTest, DoesntLoseRows2) {
     plan->close();
     ASSERT_EQ(count, num_rows);
     delete plan;
-}
\ No newline at end of file
+}
+
+TEST_F(InStreamGroupByTest, OVCMultipleAggregates) {
+    auto *plan = new AssertEqual(
+            new InStreamGroupByOVC(new SortPrefixOVC(
+                    new VectorScan({
+                                           {0, 0, {0, 3, 5}},
+                                           {0, 1, {0, 4, 2}},
+                                           {0, 2, {1, 1, 7}},
+                                           {0, 3, {1, 2, 1}},
+                                           {0, 4, {1, 6, 4}},
+                                           {0, 5, {2, 5, 9}},
+                                   }), 1), 1,
+                    aggregates::Aggregates<aggregates::fused::Sum<1>, aggregates::fused::Min<2>,
+                            aggregates::fused::Max<2>, aggregates::fused::Count>(1)),
+            new VectorScan({
+                                   {0, 0, {0, 7, 2, 5, 2}},
+                                   {0, 0, {1, 9, 1, 7, 3}},
+                                   {0, 0, {2, 5, 9, 9, 1}},
+                           })
+    );
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(InStreamGroupByTest, MultipleAggregates) {
+    auto *plan = new AssertEqual(
+            new InStreamGroupBy(
+                    new VectorScan({
+                                           {0, 0, {0, 3, 5}},
+                                           {0, 1, {0, 4, 2}},
+                                           {0, 2, {1, 1, 7}},
+                                           {0, 3, {1, 2, 1}},
+                                           {0, 4, {1, 6, 4}},
+                                           {0, 5, {2, 5, 9}},
+                                   }), 1,
+                    aggregates::Aggregates<aggregates::fused::Sum<1>, aggregates::fused::Min<2>,
+                            aggregates::fused::Max<2>, aggregates::fused::Count>(1)),
+            new VectorScan({
+                                   {0, 0, {0, 7, 2, 5, 2}},
+                                   {0, 0, {1, 9, 1, 7, 3}},
+                                   {0, 0, {2, 5, 9, 9, 1}},
+                           })
+    );
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+typedef aggregates::Aggregates<aggregates::fused::Count, aggregates::fused::Avg<2>> CountAvg;
+
+static Iterator *rollupInput() {
+    return new VectorScan({
+                                  {0, 0, {1, 1, 4}},
+                                  {0, 1, {1, 1, 6}},
+                                  {0, 2, {1, 2, 8}},
+                                  {0, 3, {2, 1, 1}},
+                                  {0, 4, {2, 1, 2}},
+                                  {0, 5, {2, 1, 3}},
+                          });
+}
+
+static Iterator *rollupOutput() {
+    return new VectorScan({
+                                  {0, 0, {1, 1, 2, 5}},
+                                  {0, 0, {1, 2, 1, 8}},
+                                  {0, 0, {1, 0, 3, 6}},
+                                  {0, 0, {2, 1, 3, 2}},
+                                  {0, 0, {2, 0, 3, 2}},
+                                  {0, 0, {0, 0, 6, 4}},
+                          });
+}
+
+TEST_F(InStreamGroupByTest, Rollup) {
+    auto *plan = new AssertEqual(new InStreamRollup(rollupInput(), 2, CountAvg(2)), rollupOutput());
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(InStreamGroupByTest, OVCRollup) {
+    auto *plan = new AssertEqual(new InStreamRollupOVC(new SortPrefixOVC(rollupInput(), 2), 2, CountAvg(2)),
+                                 rollupOutput());
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(InStreamGroupByTest, OVCRollupMinColumns) {
+    auto *plan = new AssertEqual(
+            new InStreamRollupOVC(new SortPrefixOVC(rollupInput(), 2), 2, CountAvg(2), 1),
+            new VectorScan({
+                                   {0, 0, {1, 1, 2, 5}},
+                                   {0, 0, {1, 2, 1, 8}},
+                                   {0, 0, {1, 0, 3, 6}},
+                                   {0, 0, {2, 1, 3, 2}},
+                                   {0, 0, {2, 0, 3, 2}},
+                           }));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(InStreamGroupByTest, OVCRollupAfterInSortGroupBy) {
+    auto *plan = new AssertEqual(
+            new InStreamRollupOVC(new InSortGroupByOVC(rollupInput(), 2, aggregates::Partial(CountAvg(2))),
+                                  2, CountAvg(2), 0, true),
+            rollupOutput());
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(InStreamGroupByTest, OVCRollupLevels) {
+    unsigned num_rows = 100000;
+    int group_columns = 3;
+
+    auto *plan = new InStreamRollupOVC(new SortPrefixOVC(new RowGenerator(num_rows, 8, 0, 1), group_columns),
+                                       group_columns, aggregates::Count(group_columns));
+    plan->open();
+    unsigned long counts[4] = {0};
+    unsigned long groups[4] = {0};
+    for (Row *row; (row = plan->next()); plan->free()) {
+        ASSERT_LE(row->tid, group_columns);
+        counts[row->tid] += row->columns[group_columns];
+        groups[row->tid]++;
+    }
+    plan->close();
+    for (int level = 0; level <= group_columns; level++) {
+        ASSERT_EQ(counts[level], num_rows);
+    }
+    ASSERT_EQ(groups[0], 1);
+    ASSERT_EQ(groups[1], 8);
+    ASSERT_EQ(groups[2], 64);
+    ASSERT_EQ(groups[3], 512);
+    delete plan;
+}
+
+static std::vector<Row> columnListInput() {
+    return {
+            {0, 0, {1, 7, 0, 5}},
+            {0, 0, {0, 9, 1, 2}},
+            {0, 0, {1, 7, 0, 3}},
+            {0, 0, {0, 9, 1, 4}},
+            {0, 0, {2, 8, 0, 1}},
+    };
+}
+
+TEST_F(InStreamGroupByTest, OVCColumnListSimple) {
+    uint8_t columns[] = {2, 0};
+    typedef aggregates::AggregatesAt<aggregates::fused::Sum<3>, aggregates::fused::Count> Agg;
+    auto *plan = new AssertEqual(
+            new InStreamGroupByColumnListOVC(
+                    new SortOVC2<false, CmpColumnListOVC>(new VectorScan(columnListInput()),
+                                                          CmpColumnListOVC(columns, 2)),
+                    columns, 2, Agg(3)),
+            new VectorScan({
+                                   {0, 0, {1, 7, 0, 8, 2}},
+                                   {0, 0, {2, 8, 0, 1, 1}},
+                                   {0, 0, {0, 9, 1, 6, 2}},
+                           })
+    );
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(InStreamGroupByTest, ColumnListSimple) {
+    uint8_t columns[] = {2, 0};
+    typedef aggregates::AggregatesAt<aggregates::fused::Sum<3>, aggregates::fused::Count> Agg;
+    auto *plan = new AssertEqual(
+            new InStreamGroupByColumnList(
+                    new SortBase<false, CmpColumnList>(new VectorScan(columnListInput()),
+                                                       CmpColumnList(columns, 2)),
+                    columns, 2, Agg(3)),
+            new VectorScan({
+                                   {0, 0, {1, 7, 0, 8, 2}},
+                                   {0, 0, {2, 8, 0, 1, 1}},
+                                   {0, 0, {0, 9, 1, 6, 2}},
+                           })
+    );
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(InStreamGroupByTest, OVCColumnListMatchesInSort) {
+    unsigned num_rows = 100000;
+    uint8_t columns[] = {2, 0};
+    typedef aggregates::AggregatesAt<aggregates::fused::Sum<3>, aggregates::fused::Count> Agg;
+    auto *plan = new AssertEqual(
+            new InStreamGroupByColumnListOVC(
+                    new SortOVC2<false, CmpColumnListOVC>(new RowGenerator(num_rows, {5, 0, 5, 8}, 3),
+                                                          CmpColumnListOVC(columns, 2)),
+                    columns, 2, Agg(3)),
+            new InSortGroupByColumnListOVC(new RowGenerator(num_rows, {5, 0, 5, 8}, 3), columns, 2, Agg(3))
+    );
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
@@ -0,0 +1,103 @@
+#include "lib/iterators/LeftSemiHashJoin.h"
+#include "lib/iterators/LeftSemiJoin.h"
+#include "lib/iterators/Sort.h"
+#include "lib/iterators/VectorScan.h"
+#include "lib/iterators/AssertEqual.h"
+#include "lib/iterators/GeneratorWithDomains.h"
+#include "lib/iterators/UniqueRowGenerator.h"
+#include "lib/log.h"
+
+#include <gtest/gtest.h>
+
+using namespace ovc;
+using namespace iterators;
+
+class LeftSemiHashJoinTest : public ::testing::Test {
+protected:
+
+    const size_t SEED = 1337;
+
+    void SetUp() override {
+        log_set_quiet(true);
+        log_set_level(LOG_ERROR);
+    }
+
+    void TearDown() override {
+
+    }
+
+    void testJoin(size_t left_rows, size_t right_rows, int upper, int join_columns,
+                  size_t memory_rows = HASH_JOIN_MEMORY_ROWS) {
+        auto gen_left = GeneratorWithDomains(left_rows, upper, 0, SEED);
+        auto gen_right = UniqueRowGenerator(right_rows, upper, 0, join_columns, SEED + 1);
+
+        auto merge = LeftSemiJoin(new SortPrefix(gen_left.clone(), join_columns),
+                                  new SortPrefix(gen_right.clone(), join_columns), join_columns);
+        merge.run();
+
+        auto hash = LeftSemiHashJoin(gen_left.clone(), gen_right.clone(), join_columns, memory_rows);
+        hash.run();
+
+        ASSERT_EQ(hash.getCount(), merge.getCount());
+        ASSERT_LE(hash.getFiltered(), left_rows - hash.getCount());
+        if (right_rows <= memory_rows) {
+            ASSERT_EQ(hash.getSpilledPartitions(), 0);
+        } else {
+            ASSERT_GT(hash.getSpilledPartitions(), 0);
+        }
+    }
+};
+
+TEST_F(LeftSemiHashJoinTest, Empty) {
+    auto hash = LeftSemiHashJoin(new VectorScan({}), new VectorScan({}), 1);
+    hash.run();
+    ASSERT_EQ(hash.getCount(), 0);
+}
+
+TEST_F(LeftSemiHashJoinTest, EmptyRight) {
+    auto hash = LeftSemiHashJoin(new VectorScan({{0, 0, {1, 2}},
+                                                 {0, 0, {2, 3}}}),
+                                 new VectorScan({}), 1);
+    hash.run();
+    ASSERT_EQ(hash.getCount(), 0);
+}
+
+TEST_F(LeftSemiHashJoinTest, Small) {
+    auto *plan = new AssertEqual(
+            new SortPrefix(new LeftSemiHashJoin(
+                    new VectorScan({{0, 0, {3, 1}},
+                                    {0, 0, {1, 2}},
+                                    {0, 0, {4, 3}},
+                                    {0, 0, {1, 4}},
+                                    {0, 0, {5, 5}}}),
+                    new VectorScan({{0, 0, {1, 7}},
+                                    {0, 0, {5, 8}},
+                                    {0, 0, {6, 9}}}),
+                    1), 2),
+            new VectorScan({{0, 0, {1, 2}},
+                            {0, 0, {1, 4}},
+                            {0, 0, {5, 5}}}));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(LeftSemiHashJoinTest, Selective) {
+    testJoin(100000, 1000, 1000, 2);
+}
+
+TEST_F(LeftSemiHashJoinTest, Dense) {
+    testJoin(100000, 256, 16, 2);
+}
+
+TEST_F(LeftSemiHashJoinTest, SelectiveSpilling) {
+    testJoin(100000, 10000, 1000, 2, 1000);
+}
+
+TEST_F(LeftSemiHashJoinTest, DenseSpilling) {
+    testJoin(100000, 256, 16, 2, 100);
+}
+
+TEST_F(LeftSemiHashJoinTest, AllSpilled) {
+    testJoin(10000, 1000, 100, 2, 0);
+}
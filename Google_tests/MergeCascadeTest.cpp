@@ -0,0 +1,108 @@
+#include "lib/Row.h"
+#include "lib/MergeCascade.h"
+#include "lib/comparators.h"
+#include "lib/utils.h"
+#include "lib/io/ExternalRunW.h"
+#include "lib/iterators/RowGenerator.h"
+
+#include <gtest/gtest.h>
+
+using namespace ovc;
+using namespace iterators;
+using namespace comparators;
+
+class MergeCascadeTest : public ::testing::Test {
+protected:
+    const size_t SEED = 1337;
+
+    void SetUp() override {
+        log_set_quiet(true);
+        log_set_level(LOG_ERROR);
+    }
+
+    void TearDown() override {
+    }
+
+    /**
+     * Write the rows round-robin into `num_runs` sorted external runs and merge them in a single cascade.
+     */
+    template<typename Compare>
+    void testMerge(size_t num_rows, size_t num_runs, std::initializer_list<uint8_t> bits, const Compare &cmp) {
+        auto rows = RowGenerator(num_rows, bits, SEED).collect();
+        std::sort(rows.begin(), rows.end(), [&cmp](const Row &a, const Row &b) { return cmp.raw(a, b) < 0; });
+
+        // every run that is read holds up to two buffers
+        io::BufferManager buffer_manager(std::max<size_t>(2 * num_runs, PAGES_MAX));
+        std::vector<std::string> paths;
+        for (size_t i = 0; i < num_runs; i++) {
+            paths.push_back(generate_path());
+            io::ExternalRunW run(paths.back(), buffer_manager);
+            Row *prev = nullptr;
+            for (size_t j = i; j < num_rows; j += num_runs) {
+                Row row = rows[j];
+                if constexpr (Compare::USES_OVC) {
+                    if (prev) {
+                        row.setOVC(*prev);
+                    } else {
+                        row.setOVCInitial();
+                    }
+                }
+                prev = &rows[j];
+                run.add(row);
+            }
+            run.finalize();
+        }
+
+        iterator_stats stats = {};
+        MergeCascade<Compare> cascade(&stats, cmp);
+        std::vector<io::ExternalRunR> runs;
+        runs.reserve(num_runs);
+        for (auto &path: paths) {
+            runs.emplace_back(path, buffer_manager);
+        }
+        cascade.insert(runs.data(), runs.size());
+        ASSERT_EQ(cascade.getNumLeaves(), (num_runs + MERGE_CASCADE_LEAF_RUNS - 1) / MERGE_CASCADE_LEAF_RUNS);
+
+        Row prev;
+        size_t count = 0;
+        while (!cascade.isEmpty()) {
+            Row *row = cascade.pop_external();
+            ASSERT_EQ(cmp.raw(*row, rows[count]), 0);
+            if constexpr (Compare::USES_OVC) {
+                Row expected = *row;
+                if (count == 0) {
+                    expected.setOVCInitial();
+                } else {
+                    expected.setOVC(prev);
+                }
+                ASSERT_EQ(row->key, expected.key);
+            }
+            prev = *row;
+            count++;
+        }
+        ASSERT_EQ(count, num_rows);
+
+        for (auto &run: runs) {
+            run.remove();
+        }
+    }
+};
+
+TEST_F(MergeCascadeTest, SingleLeaf) {
+    testMerge(10000, 50, {4, 4, 4, 4}, CmpOVC());
+}
+
+TEST_F(MergeCascadeTest, TwoLeaves) {
+    testMerge(30000, 100, {4, 4, 4, 4}, Cmp());
+    testMerge(30000, 100, {4, 4, 4, 4}, CmpOVC());
+}
+
+TEST_F(MergeCascadeTest, ManyLeaves) {
+    testMerge(40000, 2000, {4, 4, 4, 4}, Cmp());
+    testMerge(40000, 2000, {4, 4, 4, 4}, CmpOVC());
+}
+
+TEST_F(MergeCascadeTest, ManyDuplicates) {
+    testMerge(30000, 500, {2, 2, 2}, Cmp());
+    testMerge(30000, 500, {2, 2, 2}, CmpOVC());
+}
@@ -0,0 +1,188 @@
+#include "lib/iterators/MergeJoin.h"
+#include "lib/iterators/LeftSemiJoin.h"
+#include "lib/iterators/Sort.h"
+#include "lib/iterators/VectorScan.h"
+#include "lib/iterators/AssertEqual.h"
+#include "lib/iterators/AssertCorrectOVC.h"
+#include "lib/iterators/OVCApplier.h"
+#include "lib/iterators/GeneratorWithDomains.h"
+#include "lib/log.h"
+
+#include <gtest/gtest.h>
+
+using namespace ovc;
+using namespace iterators;
+
+class MergeJoinTest : public ::testing::Test {
+protected:
+
+    const size_t SEED = 1337;
+
+    void SetUp() override {
+        log_set_quiet(true);
+        log_set_level(LOG_ERROR);
+    }
+
+    void TearDown() override {
+
+    }
+
+    static Iterator *leftInput() {
+        return new VectorScan({{0, 0, {1, 10}},
+                               {0, 0, {2, 20}},
+                               {0, 0, {2, 21}},
+                               {0, 0, {4, 40}},
+                               {0, 0, {5, 50}}});
+    }
+
+    static Iterator *rightInput() {
+        return new VectorScan({{0, 0, {2, 100}},
+                               {0, 0, {2, 101}},
+                               {0, 0, {3, 102}},
+                               {0, 0, {4, 103}}});
+    }
+
+    /**
+     * Check the output OVCs and that the OVC variant produces as many rows as the plain one.
+     */
+    template<typename Join, typename JoinOVC>
+    void testOVC(size_t left_rows, size_t right_rows, int upper, int join_columns) {
+        auto gen_left = GeneratorWithDomains(left_rows, upper, 0, SEED);
+        auto gen_right = GeneratorWithDomains(right_rows, upper, 0, SEED + 1);
+
+        auto join = Join(new SortPrefix(gen_left.clone(), join_columns),
+                         new SortPrefix(gen_right.clone(), join_columns), join_columns);
+        join.run();
+
+        auto join_ovc = new JoinOVC(new SortPrefixOVC(gen_left.clone(), join_columns),
+                                    new SortPrefixOVC(gen_right.clone(), join_columns), join_columns);
+        auto plan = AssertCorrectOVC(join_ovc, join_columns);
+        plan.run();
+
+        ASSERT_TRUE(plan.isCorrect());
+        ASSERT_EQ(join_ovc->getCount(), join.getCount());
+    }
+};
+
+TEST_F(MergeJoinTest, InnerEmpty) {
+    auto *plan = new AssertEqual(
+            new InnerJoinOVC(new VectorScan({}), rightInput(), 1, 2, 2),
+            new VectorScan({}));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(MergeJoinTest, InnerSmall) {
+    auto *plan = new AssertEqual(
+            new InnerJoin(leftInput(), rightInput(), 1, 2, 2),
+            new VectorScan({{0, 0, {2, 20, 100}},
+                            {0, 0, {2, 20, 101}},
+                            {0, 0, {2, 21, 100}},
+                            {0, 0, {2, 21, 101}},
+                            {0, 0, {4, 40, 103}}}));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(MergeJoinTest, InnerSmallOVC) {
+    auto *plan = new AssertEqual(
+            new AssertCorrectOVC(new InnerJoinOVC(new OVCApplier(leftInput(), 1),
+                                                  new OVCApplier(rightInput(), 1), 1, 2, 2), 1),
+            new VectorScan({{0, 0, {2, 20, 100}},
+                            {0, 0, {2, 20, 101}},
+                            {0, 0, {2, 21, 100}},
+                            {0, 0, {2, 21, 101}},
+                            {0, 0, {4, 40, 103}}}));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    ASSERT_TRUE(plan->getLeftInput<AssertCorrectOVC>()->isCorrect());
+    delete plan;
+}
+
+TEST_F(MergeJoinTest, LeftOuterSmallOVC) {
+    auto *plan = new AssertEqual(
+            new AssertCorrectOVC(new LeftOuterJoinOVC(new OVCApplier(leftInput(), 1),
+                                                      new OVCApplier(rightInput(), 1), 1, 2, 2), 1),
+            new VectorScan({{0, 0, {1, 10, 0}},
+                            {0, 0, {2, 20, 100}},
+                            {0, 0, {2, 20, 101}},
+                            {0, 0, {2, 21, 100}},
+                            {0, 0, {2, 21, 101}},
+                            {0, 0, {4, 40, 103}},
+                            {0, 0, {5, 50, 0}}}));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    ASSERT_TRUE(plan->getLeftInput<AssertCorrectOVC>()->isCorrect());
+    delete plan;
+}
+
+TEST_F(MergeJoinTest, FullOuterSmallOVC) {
+    auto *plan = new AssertEqual(
+            new AssertCorrectOVC(new FullOuterJoinOVC(new OVCApplier(leftInput(), 1),
+                                                      new OVCApplier(rightInput(), 1), 1, 2, 2), 1),
+            new VectorScan({{0, 0, {1, 10, 0}},
+                            {0, 0, {2, 20, 100}},
+                            {0, 0, {2, 20, 101}},
+                            {0, 0, {2, 21, 100}},
+                            {0, 0, {2, 21, 101}},
+                            {0, 0, {3, 0, 102}},
+                            {0, 0, {4, 40, 103}},
+                            {0, 0, {5, 50, 0}}}));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    ASSERT_TRUE(plan->getLeftInput<AssertCorrectOVC>()->isCorrect());
+    delete plan;
+}
+
+TEST_F(MergeJoinTest, LeftAntiSmallOVC) {
+    auto *plan = new AssertEqual(
+            new AssertCorrectOVC(new LeftAntiJoinOVC(new OVCApplier(leftInput(), 1),
+                                                     new OVCApplier(rightInput(), 1), 1), 1),
+            new VectorScan({{0, 0, {1, 10}},
+                            {0, 0, {5, 50}}}));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    ASSERT_TRUE(plan->getLeftInput<AssertCorrectOVC>()->isCorrect());
+    delete plan;
+}
+
+TEST_F(MergeJoinTest, InnerOVC) {
+    testOVC<InnerJoin, InnerJoinOVC>(10000, 10000, 8, 3);
+}
+
+TEST_F(MergeJoinTest, LeftOuterOVC) {
+    testOVC<LeftOuterJoin, LeftOuterJoinOVC>(10000, 10000, 8, 4);
+}
+
+TEST_F(MergeJoinTest, FullOuterOVC) {
+    testOVC<FullOuterJoin, FullOuterJoinOVC>(10000, 10000, 8, 4);
+}
+
+TEST_F(MergeJoinTest, LeftAntiOVC) {
+    testOVC<LeftAntiJoin, LeftAntiJoinOVC>(10000, 10000, 8, 4);
+}
+
+TEST_F(MergeJoinTest, AntiAndSemiPartitionLeft) {
+    auto gen_left = GeneratorWithDomains(10000, 8, 0, SEED);
+    auto gen_right = GeneratorWithDomains(10000, 8, 0, SEED + 1);
+
+    auto anti = LeftAntiJoinOVC(new SortPrefixOVC(gen_left.clone(), 4),
+                                new SortPrefixOVC(gen_right.clone(), 4), 4);
+    anti.run();
+    auto semi = LeftSemiJoinOVC(new SortPrefixOVC(gen_left.clone(), 4),
+                                new SortPrefixOVC(gen_right.clone(), 4), 4);
+    semi.run();
+    auto outer = LeftOuterJoinOVC(new SortPrefixOVC(gen_left.clone(), 4),
+                                  new SortPrefixOVC(gen_right.clone(), 4), 4);
+    outer.run();
+    auto inner = InnerJoinOVC(new SortPrefixOVC(gen_left.clone(), 4),
+                              new SortPrefixOVC(gen_right.clone(), 4), 4);
+    inner.run();
+
+    ASSERT_GT(anti.getCount(), 0);
+    ASSERT_GT(semi.getCount(), 0);
+    ASSERT_EQ(anti.getCount() + semi.getCount(), 10000);
+    ASSERT_EQ(outer.getCount(), inner.getCount() + anti.getCount());
+}
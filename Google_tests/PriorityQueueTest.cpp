@@ -0,0 +1,170 @@
+#include "lib/Row.h"
+#include "lib/PriorityQueue.h"
+#include "lib/comparators.h"
+#include "lib/utils.h"
+#include "lib/iterators/RowGenerator.h"
+
+#include <gtest/gtest.h>
+
+using namespace ovc;
+using namespace iterators;
+using namespace comparators;
+
+class PriorityQueueTest : public ::testing::Test {
+protected:
+    const size_t SEED = 1337;
+
+    void SetUp() override {
+        log_set_quiet(true);
+        log_set_level(LOG_ERROR);
+    }
+
+    void TearDown() override {
+    }
+
+    /**
+     * Sort the rows with a single pass through a queue that holds all of them.
+     */
+    template<bool PACKED, typename Compare>
+    std::vector<Row> sortWithQueue(std::vector<Row> rows, const Compare &cmp) {
+        iterator_stats stats = {};
+        PriorityQueue<Compare, PACKED> queue(p2(std::max<size_t>(rows.size(), QUEUE_CAPACITY)), &stats, cmp);
+        for (auto &row: rows) {
+            if constexpr (Compare::USES_OVC) {
+                row.key = cmp.makeOVC(ROW_ARITY, 0, &row);
+            }
+            queue.push(&row, INITIAL_RUN_IDX);
+        }
+        queue.flush_sentinels();
+        std::vector<Row> res;
+        while (!queue.isEmpty()) {
+            res.push_back(*queue.popf());
+        }
+        return res;
+    }
+
+    template<typename Compare>
+    void testPacked(size_t num_rows, std::initializer_list<uint8_t> bits, const Compare &cmp) {
+        auto input = RowGenerator(num_rows, bits, SEED).collect();
+        auto plain = sortWithQueue<false>(input, cmp);
+        auto packed = sortWithQueue<true>(input, cmp);
+
+        ASSERT_EQ(plain.size(), num_rows);
+        ASSERT_EQ(packed.size(), num_rows);
+        for (size_t i = 0; i < num_rows; i++) {
+            if (i > 0) {
+                ASSERT_LE(cmp.raw(packed[i - 1], packed[i]), 0);
+            }
+            ASSERT_EQ(cmp.raw(plain[i], packed[i]), 0);
+            if constexpr (Compare::USES_OVC) {
+                ASSERT_EQ(plain[i].key, packed[i].key);
+            }
+        }
+    }
+};
+
+TEST_F(PriorityQueueTest, PackedNoOVC) {
+    testPacked(10000, {4, 4, 4, 4}, Cmp());
+}
+
+TEST_F(PriorityQueueTest, PackedNoOVCDistinctFirstColumn) {
+    testPacked(10000, {20, 4}, Cmp());
+}
+
+TEST_F(PriorityQueueTest, PackedOVC) {
+    testPacked(10000, {4, 4, 4, 4}, CmpOVC());
+}
+
+TEST_F(PriorityQueueTest, PackedOVCDuplicates) {
+    testPacked(10000, {2, 2, 2}, CmpOVC());
+}
+
+TEST_F(PriorityQueueTest, PackedPrefixOVC) {
+    testPacked(10000, {3, 3, 3, 8}, CmpPrefixOVC(3));
+}
+
+TEST_F(PriorityQueueTest, PackedColumnListOVC) {
+    uint8_t columns[] = {2, 0, 1};
+    testPacked(10000, {3, 3, 3}, CmpColumnListOVC(columns, 3));
+}
+
+/**
+ * Merge sorted in-memory runs, either clustered (run i holds the i-th range of the sorted rows) or interleaved.
+ */
+template<bool PACKED, bool SPAN, typename Compare>
+static void testMerge(size_t num_rows, size_t num_runs, bool clustered, const Compare &cmp) {
+    auto rows = RowGenerator(num_rows, {4, 4, 4, 4}, 1337).collect();
+    std::sort(rows.begin(), rows.end(), [&cmp](const Row &a, const Row &b) { return cmp.raw(a, b) < 0; });
+
+    std::vector<MemoryRun> runs(num_runs);
+    for (size_t i = 0; i < num_rows; i++) {
+        auto &run = runs[clustered ? i * num_runs / num_rows : i % num_runs];
+        if constexpr (Compare::USES_OVC) {
+            if (run.isEmpty()) {
+                rows[i].setOVCInitial();
+            } else {
+                rows[i].setOVC(*run.back());
+            }
+        }
+        run.add(&rows[i]);
+    }
+
+    iterator_stats stats = {};
+    PriorityQueue<Compare, PACKED> queue(QUEUE_CAPACITY, &stats, cmp);
+    for (auto &run: runs) {
+        queue.push_memory(run);
+    }
+    queue.flush_sentinels();
+
+    std::vector<Row> res;
+    while (!queue.isEmpty()) {
+        if constexpr (SPAN) {
+            Row **span;
+            size_t n = queue.pop_memory_span(span);
+            for (size_t i = 0; i < n; i++) {
+                res.push_back(*span[i]);
+            }
+        } else {
+            res.push_back(*queue.pop_memory());
+        }
+    }
+
+    ASSERT_EQ(res.size(), num_rows);
+    for (size_t i = 0; i < num_rows; i++) {
+        if (i > 0) {
+            ASSERT_LE(cmp.raw(res[i - 1], res[i]), 0);
+        }
+        if constexpr (Compare::USES_OVC) {
+            Row expected = res[i];
+            if (i == 0) {
+                expected.setOVCInitial();
+            } else {
+                expected.setOVC(res[i - 1]);
+            }
+            ASSERT_EQ(res[i].key, expected.key);
+        }
+    }
+}
+
+TEST_F(PriorityQueueTest, MergeClustered) {
+    testMerge<false, false>(10000, 50, true, Cmp());
+    testMerge<false, false>(10000, 50, true, CmpOVC());
+    testMerge<true, false>(10000, 50, true, Cmp());
+    testMerge<true, false>(10000, 50, true, CmpOVC());
+}
+
+TEST_F(PriorityQueueTest, MergeInterleaved) {
+    testMerge<false, false>(10000, 50, false, Cmp());
+    testMerge<false, false>(10000, 50, false, CmpOVC());
+    testMerge<true, false>(10000, 50, false, Cmp());
+    testMerge<true, false>(10000, 50, false, CmpOVC());
+}
+
+TEST_F(PriorityQueueTest, MergeSpans) {
+    testMerge<false, true>(10000, 50, true, Cmp());
+    testMerge<false, true>(10000, 50, true, CmpOVC());
+    testMerge<false, true>(10000, 50, false, Cmp());
+    testMerge<false, true>(10000, 50, false, CmpOVC());
+    testMerge<true, true>(10000, 50, true, CmpOVC());
+    testMerge<true, true>(10000, 50, false, CmpOVC());
+}
@@ -0,0 +1,79 @@
+#include "lib/RangeMax.h"
+
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace ovc;
+
+class RangeMaxTest : public ::testing::Test {
+protected:
+    const size_t SEED = 1337;
+
+    /**
+     * Compare all ranges against a linear scan over the same codes.
+     */
+    void testRanges(const RangeMax &range_max, const std::vector<OVC> &values) {
+        ASSERT_EQ(range_max.size(), values.size());
+        for (size_t begin = 0; begin <= values.size(); begin++) {
+            OVC expected = 0;
+            for (size_t end = begin; end <= values.size(); end++) {
+                if (end > begin) {
+                    expected = std::max(expected, values[end - 1]);
+                }
+                ASSERT_EQ(range_max.max(begin, end), expected);
+            }
+        }
+    }
+};
+
+TEST_F(RangeMaxTest, EmptyTest) {
+    RangeMax range_max;
+    range_max.build();
+    ASSERT_TRUE(range_max.empty());
+    ASSERT_EQ(range_max.max(0, 0), 0);
+}
+
+TEST_F(RangeMaxTest, RandomTest) {
+    std::mt19937 gen(SEED);
+    RangeMax range_max;
+    std::vector<OVC> values;
+    for (size_t i = 0; i < 300; i++) {
+        values.push_back(gen() % 1000);
+        range_max.push_back(values.back());
+        ASSERT_EQ(range_max[i], values[i]);
+    }
+    range_max.build();
+    testRanges(range_max, values);
+}
+
+TEST_F(RangeMaxTest, IncrementalTest) {
+    // codes appended between queries, including across growing the tree
+    std::mt19937 gen(SEED);
+    RangeMax range_max;
+    std::vector<OVC> values;
+    for (size_t step : {1, 5, 58, 1, 1, 100, 7}) {
+        for (size_t i = 0; i < step; i++) {
+            values.push_back(gen() % 1000);
+            range_max.push_back(values.back());
+        }
+        range_max.build();
+        testRanges(range_max, values);
+    }
+}
+
+TEST_F(RangeMaxTest, ClearTest) {
+    // stale codes of larger values must not leak into queries after clearing
+    RangeMax range_max;
+    for (size_t i = 0; i < 100; i++) {
+        range_max.push_back(1000 + i);
+    }
+    range_max.build();
+    range_max.clear();
+
+    std::vector<OVC> values = {3, 1, 4, 1, 5, 9, 2, 6};
+    for (auto ovc: values) {
+        range_max.push_back(ovc);
+    }
+    range_max.build();
+    testRanges(range_max, values);
+}
@@ -26,6 +26,17 @@ protected:
 
     void TearDown() override {
     }
+
+    /**
+     * The rows must be equal and carry the same OVCs, position by position.
+     */
+    static void assertSameRowsAndOVCs(std::vector<Row> &actual, const std::vector<Row> &expected) {
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < actual.size(); i++) {
+            ASSERT_TRUE(actual[i].equals(expected[i]));
+            ASSERT_EQ(actual[i].key, expected[i].key);
+        }
+    }
 };
 
 TEST_F(SegmentedSortTest, EmptyTest) {
@@ -193,4 +204,194 @@ TEST_F(SegmentedSortTest, BigTest4OVC) {
     plan.run();
     ASSERT_TRUE(plan.isSorted());
     ASSERT_TRUE(plan.getCount() == num_rows);
-}
\ No newline at end of file
+}
+TEST_F(SegmentedSortTest, ParallelTest) {
+    unsigned long domain = 64;
+    unsigned long num_rows = 1 << 14;
+
+    uint8_t A[ROW_ARITY] = {0};
+    uint8_t B[ROW_ARITY] = {1};
+    uint8_t ACB[ROW_ARITY] = {0, 2, 1};
+    uint8_t CB[ROW_ARITY] = {2, 1};
+
+    auto make_plan = [&]() {
+        return new SegmentedSort(
+                new RowBuffer(
+                        new SortPrefix(new GeneratorWithDomains(num_rows, {domain, domain, domain}, SEED), 3),
+                        num_rows),
+                A, 1, B, 1, CB, 2);
+    };
+
+    auto plan = AssertSorted(new AssertEqual(make_plan()->parallel(4), make_plan()), CmpColumnList(ACB, 3));
+    plan.run();
+    ASSERT_TRUE(plan.isSorted());
+    ASSERT_TRUE(plan.getInput<AssertEqual>()->isEqual());
+    ASSERT_EQ(plan.getCount(), num_rows);
+}
+
+TEST_F(SegmentedSortTest, ParallelTestOVC) {
+    unsigned long domain = 16;
+    unsigned long num_rows = 1 << 14;
+
+    uint8_t ABC[ROW_ARITY] = {0, 1, 2, 3, 4, 5};
+
+    auto make_plan = [&]() {
+        return new SegmentedSortOVC(
+                new RowBuffer(
+                        new SortPrefixOVC(
+                                new GeneratorWithDomains(num_rows, {domain, domain, domain, domain, domain, domain},
+                                                         SEED),
+                                6),
+                        num_rows),
+                ABC, 1, 2, 3);
+    };
+
+    auto parallel = make_plan();
+    parallel->parallel(4);
+    auto sequential = make_plan();
+    auto rows = parallel->collect();
+    auto expected = sequential->collect();
+
+    ASSERT_EQ(rows.size(), num_rows);
+    assertSameRowsAndOVCs(rows, expected);
+    delete parallel;
+    delete sequential;
+}
+
+TEST_F(SegmentedSortTest, SpillTest) {
+    unsigned long domain = 64;
+    unsigned long num_rows = 1 << 14;
+
+    uint8_t A[ROW_ARITY] = {0};
+    uint8_t B[ROW_ARITY] = {1};
+    uint8_t ACB[ROW_ARITY] = {0, 2, 1};
+    uint8_t CB[ROW_ARITY] = {2, 1};
+
+    auto make_plan = [&]() {
+        return new SegmentedSort(
+                new SortPrefix(new GeneratorWithDomains(num_rows, {4, domain, domain}, SEED), 3),
+                A, 1, B, 1, CB, 2);
+    };
+
+    auto plan = AssertSorted(new AssertEqual(make_plan()->memoryBudget(256), make_plan()), CmpColumnList(ACB, 3));
+    plan.run();
+    ASSERT_TRUE(plan.isSorted());
+    ASSERT_TRUE(plan.getInput<AssertEqual>()->isEqual());
+    ASSERT_EQ(plan.getCount(), num_rows);
+}
+
+TEST_F(SegmentedSortTest, SpillTestOVC) {
+    unsigned long domain = 16;
+    unsigned long num_rows = 1 << 14;
+
+    uint8_t ABC[ROW_ARITY] = {0, 1, 2, 3, 4, 5};
+
+    auto make_plan = [&]() {
+        return new SegmentedSortOVC(
+                new SortPrefixOVC(
+                        new GeneratorWithDomains(num_rows, {domain, domain, domain, domain, domain, domain}, SEED),
+                        6),
+                ABC, 1, 2, 3);
+    };
+
+    auto spilling = make_plan();
+    spilling->memoryBudget(64);
+    auto in_memory = make_plan();
+    auto rows = spilling->collect();
+    auto expected = in_memory->collect();
+
+    ASSERT_EQ(rows.size(), num_rows);
+    assertSameRowsAndOVCs(rows, expected);
+    ASSERT_GT(spilling->getStats().rows_written, 0);
+    delete spilling;
+    delete in_memory;
+}
+
+TEST_F(SegmentedSortTest, ManyRunsTestOVC) {
+    // more B-runs per segment than the queue can merge at once
+    unsigned long num_rows = 1 << 14;
+
+    uint8_t ABC[ROW_ARITY] = {0, 1, 2};
+    uint8_t ACB[ROW_ARITY] = {0, 2, 1};
+
+    auto rows = SegmentedSortOVC(
+            new SortPrefixOVC(new GeneratorWithDomains(num_rows, {2, 4096, 8}, SEED), 3),
+            ABC, 1, 1, 1).collect();
+    auto expected = SortOVC2<false, CmpColumnListOVC>(
+            new GeneratorWithDomains(num_rows, {2, 4096, 8}, SEED),
+            CmpColumnListOVC(ACB, 3)).collect();
+
+    ASSERT_EQ(rows.size(), num_rows);
+    assertSameRowsAndOVCs(rows, expected);
+}
+
+TEST_F(SegmentedSortTest, MultiPassTestOVC) {
+    // a single segment that spills more runs than the fan-in of a merge
+    unsigned long num_rows = 1 << 15;
+
+    uint8_t ABC[ROW_ARITY] = {0, 1, 2, 3};
+    uint8_t ACB[ROW_ARITY] = {0, 2, 3, 1};
+
+    auto plan = SegmentedSortOVC(
+            new SortPrefixOVC(new GeneratorWithDomains(num_rows, {1, 64, 64, 64}, SEED), 4),
+            ABC, 1, 1, 2);
+    plan.memoryBudget(64);
+    auto rows = plan.collect();
+    auto expected = SortOVC2<false, CmpColumnListOVC>(
+            new GeneratorWithDomains(num_rows, {1, 64, 64, 64}, SEED),
+            CmpColumnListOVC(ACB, 4)).collect();
+
+    ASSERT_EQ(rows.size(), num_rows);
+    assertSameRowsAndOVCs(rows, expected);
+    ASSERT_GT(plan.getStats().rows_written, num_rows);
+}
+
+TEST_F(SegmentedSortTest, ParallelSpillTestOVC) {
+    unsigned long num_rows = 1 << 14;
+
+    uint8_t ABC[ROW_ARITY] = {0, 1, 2, 3};
+
+    // segments of very different sizes, some of them spill
+    auto make_plan = [&]() {
+        return new SegmentedSortOVC(
+                new SortPrefixOVC(new GeneratorWithDomains(num_rows, {64, 16, 16, 16}, SEED), 4),
+                ABC, 1, 1, 2);
+    };
+
+    auto parallel = make_plan();
+    parallel->parallel(4)->memoryBudget(512);
+    auto sequential = make_plan();
+    auto rows = parallel->collect();
+    auto expected = sequential->collect();
+
+    ASSERT_EQ(rows.size(), num_rows);
+    assertSameRowsAndOVCs(rows, expected);
+    ASSERT_GT(parallel->getStats().rows_written, 0);
+    delete parallel;
+    delete sequential;
+}
+
+TEST_F(SegmentedSortTest, ParallelManyBatchesTestOVC) {
+    unsigned long num_rows = 1 << 16;
+
+    uint8_t ABC[ROW_ARITY] = {0, 1, 2, 3};
+
+    // thousands of small segments, the same workers sort many batches
+    auto make_plan = [&]() {
+        return new SegmentedSortOVC(
+                new SortPrefixOVC(new GeneratorWithDomains(num_rows, {4096, 4, 16, 16}, SEED), 4),
+                ABC, 1, 1, 2);
+    };
+
+    auto parallel = make_plan();
+    parallel->parallel(3)->memoryBudget(1024);
+    auto sequential = make_plan();
+    auto rows = parallel->collect();
+    auto expected = sequential->collect();
+
+    ASSERT_EQ(rows.size(), num_rows);
+    assertSameRowsAndOVCs(rows, expected);
+    ASSERT_EQ(parallel->getStats().rows_written, 0);
+    delete parallel;
+    delete sequential;
+}
@@ -0,0 +1,118 @@
+#include "lib/Row.h"
+#include "lib/iterators/SetOps.h"
+#include "lib/iterators/Sort.h"
+#include "lib/iterators/VectorScan.h"
+#include "lib/iterators/AssertEqual.h"
+#include "lib/iterators/AssertCorrectOVC.h"
+#include "lib/iterators/OVCApplier.h"
+#include "lib/iterators/RowGenerator.h"
+#include "lib/log.h"
+
+#include <gtest/gtest.h>
+
+using namespace ovc;
+using namespace iterators;
+
+class SetOpsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log_set_quiet(false);
+        log_set_level(LOG_ERROR);
+    }
+
+    void TearDown() override {
+    }
+};
+
+static Iterator *scan(std::initializer_list<unsigned long> values) {
+    std::vector<Row> rows;
+    for (unsigned long v: values) {
+        rows.push_back({0, 0, {v}});
+    }
+    return new VectorScan(rows);
+}
+
+static Iterator *leftInput() {
+    return scan({1, 1, 1, 2, 3, 5, 5});
+}
+
+static Iterator *rightInput() {
+    return scan({1, 2, 2, 4, 5, 5, 5, 6});
+}
+
+template<SetOpType TYPE>
+static void check(std::initializer_list<unsigned long> expected) {
+    {
+        auto *plan = new AssertEqual(new SetOp<TYPE>(leftInput(), rightInput()), scan(expected));
+        plan->run();
+        ASSERT_TRUE(plan->isEqual());
+        delete plan;
+    }
+    {
+        auto *assert_ovc = new AssertCorrectOVC(
+                new SetOpOVC<TYPE>(new OVCApplier(leftInput()), new OVCApplier(rightInput())));
+        auto *plan = new AssertEqual(assert_ovc, scan(expected));
+        plan->run();
+        ASSERT_TRUE(plan->isEqual());
+        ASSERT_TRUE(assert_ovc->isCorrect());
+        delete plan;
+    }
+}
+
+template<SetOpType TYPE>
+static unsigned long count(unsigned long num_left, unsigned long num_right) {
+    auto *assert_ovc = new AssertCorrectOVC(
+            new SetOpOVC<TYPE>(new SortOVC(new RowGenerator(num_left, {4, 4, 2}, 1)),
+                               new SortOVC(new RowGenerator(num_right, {4, 4, 2}, 2))));
+    auto *plan = new AssertEqual(
+            assert_ovc,
+            new SetOp<TYPE>(new SortOVC(new RowGenerator(num_left, {4, 4, 2}, 1)),
+                            new SortOVC(new RowGenerator(num_right, {4, 4, 2}, 2))));
+    plan->run();
+    EXPECT_TRUE(plan->isEqual());
+    EXPECT_TRUE(assert_ovc->isCorrect());
+    unsigned long res = plan->getCount();
+    delete plan;
+    return res;
+}
+
+TEST_F(SetOpsTest, EmptyTest) {
+    auto *plan = new AssertEqual(new SetOpOVC<UNION>(scan({}), scan({})), scan({}));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(SetOpsTest, Union) {
+    check<UNION>({1, 2, 3, 4, 5, 6});
+}
+
+TEST_F(SetOpsTest, UnionAll) {
+    check<UNION_ALL>({1, 1, 1, 1, 2, 2, 2, 3, 4, 5, 5, 5, 5, 5, 6});
+}
+
+TEST_F(SetOpsTest, Intersect) {
+    check<INTERSECT>({1, 2, 5});
+}
+
+TEST_F(SetOpsTest, IntersectAll) {
+    check<INTERSECT_ALL>({1, 2, 5, 5});
+}
+
+TEST_F(SetOpsTest, Except) {
+    check<EXCEPT>({3});
+}
+
+TEST_F(SetOpsTest, ExceptAll) {
+    check<EXCEPT_ALL>({1, 1, 3});
+}
+
+TEST_F(SetOpsTest, Identities) {
+    unsigned long num_left = 50000;
+    unsigned long num_right = 30000;
+    ASSERT_EQ(count<UNION_ALL>(num_left, num_right), num_left + num_right);
+    ASSERT_EQ(count<INTERSECT_ALL>(num_left, num_right) + count<EXCEPT_ALL>(num_left, num_right), num_left);
+    ASSERT_EQ(count<INTERSECT>(num_left, num_right) + count<EXCEPT>(num_left, num_right),
+              count<UNION>(num_left, 0));
+    ASSERT_LE(count<UNION>(num_left, num_right), num_left + num_right);
+}
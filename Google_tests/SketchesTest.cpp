@@ -0,0 +1,115 @@
+#include "lib/Row.h"
+#include "lib/aggregates.h"
+#include "lib/sketches.h"
+#include "lib/iterators/HashGroupBy.h"
+#include "lib/iterators/InSortGroupBy.h"
+#include "lib/iterators/VectorScan.h"
+#include "lib/log.h"
+
+#include <gtest/gtest.h>
+
+using namespace ovc;
+using namespace iterators;
+using namespace aggregates::fused;
+
+class SketchesTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log_set_quiet(false);
+        log_set_level(LOG_ERROR);
+    }
+
+    void TearDown() override {
+    }
+};
+
+/**
+ * Four groups in column 0, column 1 is distinct within each group, column 2 cycles through 1..1000.
+ */
+static std::vector<Row> generate(size_t num_rows) {
+    std::vector<Row> rows(num_rows);
+    for (size_t i = 0; i < num_rows; i++) {
+        rows[i] = {0, i, {i % 4, i, i / 4 % 1000 + 1}};
+    }
+    return rows;
+}
+
+typedef aggregates::Aggregates<CountDistinct<1, 8>, CountDistinct<2, 8>, Quantile<2, 50, 6>, Quantile<2, 99, 6>,
+        aggregates::fused::Count> Sketches;
+
+static void check_groups(Iterator *plan, size_t num_rows) {
+    plan->open();
+    size_t groups = 0;
+    for (Row *row; (row = plan->next()); plan->free()) {
+        groups++;
+        double group_size = num_rows / 4;
+        // 64 registers have a standard error of 13%
+        ASSERT_NEAR(row->columns[1], group_size, 0.4 * group_size);
+        ASSERT_NEAR(row->columns[9], 1000, 400);
+        ASSERT_NEAR(row->columns[17], 500, 500 / 8.0);
+        ASSERT_NEAR(row->columns[23], 990, 990 / 8.0);
+        ASSERT_EQ(row->columns[29], group_size);
+    }
+    plan->close();
+    ASSERT_EQ(groups, 4);
+    delete plan;
+}
+
+TEST_F(SketchesTest, InSortGroupBy) {
+    size_t num_rows = 100000;
+    check_groups(new InSortGroupByOVC(new VectorScan(generate(num_rows)), 1, Sketches(1)), num_rows);
+}
+
+TEST_F(SketchesTest, HashGroupBy) {
+    size_t num_rows = 100000;
+    check_groups(new HashGroupBy(new VectorScan(generate(num_rows)), 1, Sketches(1)), num_rows);
+}
+
+TEST_F(SketchesTest, CountDistinctSmall) {
+    Row acc = {0, 0, {0, 1}};
+    CountDistinct<1>::init(acc.columns + 2, acc.columns[1]);
+    for (unsigned long v: {2, 3, 1, 2, 4, 5, 5}) {
+        Row row = {0, 0, {0, v}};
+        CountDistinct<1>::init(row.columns + 2, row.columns[1]);
+        CountDistinct<1>::merge(acc.columns + 2, row.columns + 2);
+    }
+    ASSERT_EQ(CountDistinct<1>::estimate(acc.columns + 2), 5);
+}
+
+TEST_F(SketchesTest, QuantileBuckets) {
+    typedef Quantile<0, 50> Q;
+    for (unsigned long v: {0ul, 1ul, 7ul, 8ul, 9ul, 100ul, 12345ul, 1ul << 40, ~0ul}) {
+        unsigned long r = Q::representative(Q::bucket(v));
+        ASSERT_LE(Q::bucket(Q::representative(Q::bucket(v))), Q::bucket(v));
+        ASSERT_GE(Q::bucket(Q::representative(Q::bucket(v))), Q::bucket(v));
+        ASSERT_NEAR((double) r, (double) v, v / 8.0);
+    }
+}
+
+TEST_F(SketchesTest, QuantileCollapsesLowBuckets) {
+    typedef Quantile<0, 50, 4> Q;
+    unsigned long acc[Q::WIDTH];
+    Q::init(acc, 1000000);
+    for (unsigned long v = 1; v <= 1000000; v *= 2) {
+        unsigned long state[Q::WIDTH];
+        Q::init(state, v);
+        Q::merge(acc, state);
+    }
+    // the window covers 6 buckets, all small values end up in the lowest one
+    ASSERT_NEAR(Q::estimate(acc, 1.0), 1000000, 1000000 / 8.0);
+    ASSERT_LT(Q::estimate(acc, 0.0), 1000000);
+}
+
+TEST_F(SketchesTest, Quantiles) {
+    typedef Quantile<0, 50> Q;
+    unsigned long acc[Q::WIDTH];
+    Q::init(acc, 1);
+    for (unsigned long v = 2; v <= 10000; v++) {
+        unsigned long state[Q::WIDTH];
+        Q::init(state, v);
+        Q::merge(acc, state);
+    }
+    ASSERT_NEAR(Q::estimate(acc, 0.5), 5000, 5000 / 8.0);
+    ASSERT_NEAR(Q::estimate(acc, 0.9), 9000, 9000 / 8.0);
+    ASSERT_NEAR(Q::estimate(acc, 0.99), 9900, 9900 / 8.0);
+}
@@ -3,6 +3,8 @@
 #include "lib/iterators/Sort.h"
 #include "lib/iterators/VectorScan.h"
 #include "lib/iterators/GeneratorWithDomains.h"
+#include "lib/iterators/AssertEqual.h"
+#include "lib/iterators/RowGenerator.h"
 
 #include <gtest/gtest.h>
 
@@ -38,6 +40,29 @@ protected:
         ASSERT_TRUE(plan->isSortedAndUnique());
         delete plan;
     }
+
+    /**
+     * Compare a SortDistinctOVC set up by `configure` against the default configuration. With `presorted_input`, the
+     * input is sorted first and the operator must detect that when `configure` enables it.
+     */
+    template<typename Configure>
+    void testSortDistinctMode(size_t num_rows, const Configure &configure, bool presorted_input = false) const {
+        Iterator *input = new RowGenerator(num_rows, {6, 6, 6}, SEED);
+        if (presorted_input) {
+            input = new SortOVC(input);
+        }
+        auto *distinct = new SortDistinctOVC(input);
+        configure(distinct);
+        auto *plan = new AssertSortedUnique(
+                new AssertEqual(distinct, new SortDistinctOVC(new RowGenerator(num_rows, {6, 6, 6}, SEED))));
+        plan->run();
+        ASSERT_TRUE(plan->isSortedAndUnique());
+        ASSERT_TRUE(plan->getInput<AssertEqual>()->isEqual());
+        if (presorted_input) {
+            ASSERT_TRUE(distinct->wasPresorted());
+        }
+        delete plan;
+    }
 };
 
 TEST_F(SortDistinctTest, EmptyTest) {
@@ -166,4 +191,54 @@ TEST_F(SortDistinctTest, SortMediumButABitLarger2) {
 
 //TEST_F(SortDistinctTest, SortLarge) {
 //    testSortDistinct(INITIAL_RUNS * QUEUE_SIZE * 8);
-//}
\ No newline at end of file
+//}
+
+TEST_F(SortDistinctTest, SortOVCHeavyHitters) {
+    size_t num_rows = QUEUE_SIZE * INITIAL_RUNS * 4;
+    auto *distinct = new SortDistinctOVC(new RowGenerator(num_rows, {6, 6}, SEED));
+    distinct->trackHeavyHitters();
+    auto *plan = new AssertSortedUnique(
+            new AssertEqual(distinct, new SortDistinctOVC(new RowGenerator(num_rows, {6, 6}, SEED))));
+    plan->run();
+    ASSERT_TRUE(plan->isSortedAndUnique());
+    ASSERT_TRUE(plan->getInput<AssertEqual>()->isEqual());
+    ASSERT_GT(distinct->getHeavyHitterHits(), 0);
+    delete plan;
+}
+
+TEST_F(SortDistinctTest, SortHeavyHitters) {
+    size_t num_rows = QUEUE_SIZE * INITIAL_RUNS * 4;
+    auto *distinct = new SortDistinct(new RowGenerator(num_rows, {6, 6}, SEED));
+    distinct->trackHeavyHitters();
+    auto *plan = new AssertSortedUnique(
+            new AssertEqual(distinct, new SortDistinct(new RowGenerator(num_rows, {6, 6}, SEED))));
+    plan->run();
+    ASSERT_TRUE(plan->isSortedAndUnique());
+    ASSERT_TRUE(plan->getInput<AssertEqual>()->isEqual());
+    ASSERT_GT(distinct->getHeavyHitterHits(), 0);
+    delete plan;
+}
+
+TEST_F(SortDistinctTest, SortOVCReplacementSelection) {
+    testSortDistinctMode(QUEUE_SIZE * INITIAL_RUNS * 4, [](SortDistinctOVC *distinct) {
+        distinct->replacementSelection();
+    });
+}
+
+TEST_F(SortDistinctTest, SortOVCPresorted) {
+    testSortDistinctMode(QUEUE_SIZE * INITIAL_RUNS * 2, [](SortDistinctOVC *distinct) {
+        distinct->detectPresorted();
+    }, true);
+}
+
+TEST_F(SortDistinctTest, SortOVCRadixPartitioning) {
+    testSortDistinctMode(QUEUE_SIZE * INITIAL_RUNS * 2, [](SortDistinctOVC *distinct) {
+        distinct->radixPartitioning();
+    });
+}
+
+TEST_F(SortDistinctTest, SortOVCIndirect) {
+    testSortDistinctMode(QUEUE_SIZE * INITIAL_RUNS * 2, [](SortDistinctOVC *distinct) {
+        distinct->indirectSort();
+    });
+}
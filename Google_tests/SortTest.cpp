@@ -3,7 +3,9 @@
 #include "lib/iterators/VectorScan.h"
 #include "lib/iterators/Sort.h"
 #include "lib/iterators/AssertEqual.h"
+#include "lib/iterators/AssertCorrectOVC.h"
 #include "lib/iterators/GeneratorWithDomains.h"
+#include "lib/iterators/RowGenerator.h"
 #include "lib/comparators.h"
 
 #include <gtest/gtest.h>
@@ -201,4 +203,171 @@ TEST_F(SortTest, SortMediumButABitLarger2) {
 //
 //TEST_F(SortTest, SortLarge) {
 //    testInSortDistinct(INITIAL_RUNS * QUEUE_SIZE * 8);
-//}
\ No newline at end of file
+//}
+TEST_F(SortTest, SortOVCReplacementSelection) {
+    size_t num_rows = INITIAL_RUNS * QUEUE_SIZE * 8;
+    auto *plain = new SortOVC(new GeneratorWithDomains(num_rows, 100, 0, SEED));
+    auto *sort = new SortOVC(new GeneratorWithDomains(num_rows, 100, 0, SEED));
+    sort->replacementSelection();
+    auto *correct = new AssertCorrectOVC(sort);
+    auto *sorted = new AssertSorted(correct);
+    auto *plan = new AssertEqual(sorted, plain);
+    plan->run();
+    ASSERT_TRUE(correct->isCorrect());
+    ASSERT_TRUE(sorted->isSorted());
+    ASSERT_EQ(sorted->getCount(), num_rows);
+    ASSERT_TRUE(plan->isEqual());
+    // runs are about twice as long as the workspace on random input
+    ASSERT_LT(sort->getInitialRuns() * 3, plain->getInitialRuns() * 2);
+    delete plan;
+}
+
+TEST_F(SortTest, SortReplacementSelection) {
+    size_t num_rows = INITIAL_RUNS * QUEUE_SIZE * 3 + 17;
+    auto *sort = new Sort(new GeneratorWithDomains(num_rows, 100, 0, SEED));
+    sort->replacementSelection();
+    auto *sorted = new AssertSorted(sort);
+    auto *plan = new AssertEqual(sorted, new Sort(new GeneratorWithDomains(num_rows, 100, 0, SEED)));
+    plan->run();
+    ASSERT_TRUE(sorted->isSorted());
+    ASSERT_EQ(sorted->getCount(), num_rows);
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(SortTest, SortOVCReplacementSelectionNearlySorted) {
+    size_t num_rows = INITIAL_RUNS * QUEUE_SIZE * 6;
+    auto rows = GeneratorWithDomains(num_rows, 100, 0, SEED).collect();
+    Cmp cmp;
+    std::sort(rows.begin(), rows.end(), [cmp](const Row &a, const Row &b) -> bool { return cmp(a, b) < 0; });
+    // displace rows by less than the workspace size
+    for (size_t i = 0; i + 1000 < num_rows; i += 997) {
+        std::swap(rows[i], rows[i + 1000]);
+    }
+    auto *sort = new SortOVC(new VectorScan(rows));
+    sort->replacementSelection();
+    auto *correct = new AssertCorrectOVC(sort);
+    auto *sorted = new AssertSorted(correct);
+    std::sort(rows.begin(), rows.end(), [cmp](const Row &a, const Row &b) -> bool { return cmp(a, b) < 0; });
+    auto *plan = new AssertEqual(sorted, new VectorScan(rows));
+    plan->run();
+    ASSERT_TRUE(correct->isCorrect());
+    ASSERT_TRUE(sorted->isSorted());
+    ASSERT_EQ(sorted->getCount(), num_rows);
+    ASSERT_TRUE(plan->isEqual());
+    ASSERT_EQ(sort->getInitialRuns(), 1);
+    delete plan;
+}
+
+TEST_F(SortTest, SortOVCPresorted) {
+    for (size_t num_rows: {(size_t) 1000, INITIAL_RUNS * QUEUE_SIZE * 3}) {
+        auto rows = GeneratorWithDomains(num_rows, 100, 0, SEED).collect();
+        Cmp cmp;
+        std::sort(rows.begin(), rows.end(), [cmp](const Row &a, const Row &b) -> bool { return cmp(a, b) < 0; });
+        auto *sort = new SortOVC(new VectorScan(rows));
+        sort->detectPresorted();
+        auto *correct = new AssertCorrectOVC(sort);
+        auto *plan = new AssertEqual(correct, new VectorScan(rows));
+        plan->run();
+        ASSERT_TRUE(correct->isCorrect());
+        ASSERT_TRUE(plan->isEqual());
+        ASSERT_EQ(sort->getCount(), num_rows);
+        ASSERT_TRUE(sort->wasPresorted());
+        ASSERT_LE(sort->getInitialRuns(), 1);
+        delete plan;
+    }
+}
+
+TEST_F(SortTest, SortOVCPresortedNotDetectedByDefault) {
+    size_t num_rows = 1000;
+    auto rows = GeneratorWithDomains(num_rows, 100, 0, SEED).collect();
+    Cmp cmp;
+    std::sort(rows.begin(), rows.end(), [cmp](const Row &a, const Row &b) -> bool { return cmp(a, b) < 0; });
+    auto *sort = new SortOVC(new VectorScan(rows));
+    auto *plan = new AssertEqual(sort, new VectorScan(rows));
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    ASSERT_FALSE(sort->wasPresorted());
+    delete plan;
+}
+
+TEST_F(SortTest, SortPresortedPrefix) {
+    for (size_t num_rows: {(size_t) 1000, INITIAL_RUNS * QUEUE_SIZE * 3}) {
+        auto rows = GeneratorWithDomains(num_rows, 100, 0, SEED).collect();
+        Cmp cmp;
+        // only the first 90% of the input are ordered
+        std::sort(rows.begin(), rows.begin() + num_rows * 9 / 10,
+                  [cmp](const Row &a, const Row &b) -> bool { return cmp(a, b) < 0; });
+        auto *sort = new Sort(new VectorScan(rows));
+        sort->detectPresorted();
+        auto *sorted = new AssertSorted(sort);
+        std::sort(rows.begin(), rows.end(), [cmp](const Row &a, const Row &b) -> bool { return cmp(a, b) < 0; });
+        auto *plan = new AssertEqual(sorted, new VectorScan(rows));
+        plan->run();
+        ASSERT_TRUE(sorted->isSorted());
+        ASSERT_TRUE(plan->isEqual());
+        ASSERT_EQ(sorted->getCount(), num_rows);
+        ASSERT_FALSE(sort->wasPresorted());
+        delete plan;
+    }
+}
+
+TEST_F(SortTest, SortOVCRadixPartitioning) {
+    size_t num_rows = INITIAL_RUNS * QUEUE_SIZE * 2 + 17;
+    for (uint8_t bits: {0, 6, 32}) {
+        auto *sort = new SortOVC(new RowGenerator(num_rows, {bits, 4, 4, 4}, SEED));
+        sort->radixPartitioning();
+        auto *correct = new AssertCorrectOVC(sort);
+        auto *sorted = new AssertSorted(correct);
+        auto *plan = new AssertEqual(sorted, new SortOVC(new RowGenerator(num_rows, {bits, 4, 4, 4}, SEED)));
+        plan->run();
+        ASSERT_TRUE(sorted->isSorted());
+        ASSERT_TRUE(correct->isCorrect());
+        ASSERT_TRUE(plan->isEqual());
+        ASSERT_EQ(sorted->getCount(), num_rows);
+        delete plan;
+    }
+}
+
+TEST_F(SortTest, SortRadixPartitioning) {
+    size_t num_rows = INITIAL_RUNS * QUEUE_SIZE + 17;
+    auto *sort = new Sort(new RowGenerator(num_rows, {32, 4, 4, 4}, SEED));
+    sort->radixPartitioning();
+    auto *sorted = new AssertSorted(sort);
+    auto *plan = new AssertEqual(sorted, new Sort(new RowGenerator(num_rows, {32, 4, 4, 4}, SEED)));
+    plan->run();
+    ASSERT_TRUE(sorted->isSorted());
+    ASSERT_TRUE(plan->isEqual());
+    ASSERT_EQ(sorted->getCount(), num_rows);
+    delete plan;
+}
+
+TEST_F(SortTest, SortOVCIndirect) {
+    size_t num_rows = INITIAL_RUNS * QUEUE_SIZE * 2 + 17;
+    for (uint8_t bits: {0, 6, 32}) {
+        auto *sort = new SortOVC(new RowGenerator(num_rows, {bits, 4, 4, 4}, SEED));
+        sort->indirectSort();
+        auto *correct = new AssertCorrectOVC(sort);
+        auto *sorted = new AssertSorted(correct);
+        auto *plan = new AssertEqual(sorted, new SortOVC(new RowGenerator(num_rows, {bits, 4, 4, 4}, SEED)));
+        plan->run();
+        ASSERT_TRUE(sorted->isSorted());
+        ASSERT_TRUE(correct->isCorrect());
+        ASSERT_TRUE(plan->isEqual());
+        ASSERT_EQ(sorted->getCount(), num_rows);
+        delete plan;
+    }
+}
+
+TEST_F(SortTest, SortIndirect) {
+    size_t num_rows = INITIAL_RUNS * QUEUE_SIZE + 17;
+    auto *sort = new Sort(new RowGenerator(num_rows, {6, 4, 4, 4}, SEED));
+    sort->indirectSort();
+    auto *sorted = new AssertSorted(sort);
+    auto *plan = new AssertEqual(sorted, new Sort(new RowGenerator(num_rows, {6, 4, 4, 4}, SEED)));
+    plan->run();
+    ASSERT_TRUE(sorted->isSorted());
+    ASSERT_TRUE(plan->isEqual());
+    ASSERT_EQ(sorted->getCount(), num_rows);
+    delete plan;
+}
@@ -0,0 +1,140 @@
+#include "lib/Row.h"
+#include "lib/iterators/TopK.h"
+#include "lib/iterators/Sort.h"
+#include "lib/iterators/VectorScan.h"
+#include "lib/iterators/AssertEqual.h"
+#include "lib/iterators/AssertCorrectOVC.h"
+#include "lib/iterators/RowGenerator.h"
+#include "lib/log.h"
+
+#include <gtest/gtest.h>
+
+using namespace ovc;
+using namespace iterators;
+
+class TopKTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log_set_quiet(false);
+        log_set_level(LOG_ERROR);
+    }
+
+    void TearDown() override {
+    }
+};
+
+/**
+ * Collect the first k rows of the sorted input, compared on the first `prefix` columns only.
+ */
+static std::vector<Row> first_k(Iterator *input, size_t k, int prefix) {
+    Iterator *plan = new SortPrefix(input, prefix);
+    std::vector<Row> rows;
+    plan->open();
+    for (Row *row; rows.size() < k && (row = plan->next()); plan->free()) {
+        rows.push_back(*row);
+    }
+    plan->close();
+    delete plan;
+    return rows;
+}
+
+static void check(Iterator *plan, const std::vector<Row> &expected, int prefix, bool ovc = true) {
+    auto *assert_ovc = new AssertCorrectOVC(plan, prefix);
+    assert_ovc->open();
+    size_t i = 0;
+    for (Row *row; (row = assert_ovc->next()); assert_ovc->free(), i++) {
+        ASSERT_LT(i, expected.size());
+        for (int j = 0; j < prefix; j++) {
+            ASSERT_EQ(row->columns[j], expected[i].columns[j]);
+        }
+    }
+    assert_ovc->close();
+    ASSERT_EQ(i, expected.size());
+    ASSERT_TRUE(assert_ovc->isCorrect() || !ovc);
+    delete assert_ovc;
+}
+
+TEST_F(TopKTest, EmptyTest) {
+    auto *plan = new AssertEqual(
+            new TopKOVC(new RowGenerator(0, 0, 0), 10),
+            new VectorScan({})
+    );
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(TopKTest, ZeroTest) {
+    auto *plan = new AssertEqual(
+            new TopKOVC(new RowGenerator(1000, 100, 0), 0),
+            new VectorScan({})
+    );
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(TopKTest, Simple) {
+    auto *plan = new AssertEqual(
+            new TopK(new VectorScan({
+                                            {0, 0, {5, 1}},
+                                            {0, 0, {3, 2}},
+                                            {0, 0, {7, 3}},
+                                            {0, 0, {3, 1}},
+                                            {0, 0, {1, 4}},
+                                    }), 3),
+            new VectorScan({
+                                   {0, 0, {1, 4}},
+                                   {0, 0, {3, 1}},
+                                   {0, 0, {3, 2}},
+                           })
+    );
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(TopKTest, LessRowsThanK) {
+    size_t num_rows = 100;
+    check(new TopKOVC(new RowGenerator(num_rows, 100, 0, 1), 1000),
+          first_k(new RowGenerator(num_rows, 100, 0, 1), 1000, ROW_ARITY), ROW_ARITY);
+}
+
+TEST_F(TopKTest, SmallK) {
+    size_t num_rows = 100000;
+    size_t k = 10;
+    auto *plan = new TopKOVC(new RowGenerator(num_rows, 100, 0, 1), k);
+    check(plan, first_k(new RowGenerator(num_rows, 100, 0, 1), k, ROW_ARITY), ROW_ARITY);
+}
+
+TEST_F(TopKTest, LargeK) {
+    size_t num_rows = 100000;
+    size_t k = 5000;
+    check(new TopKOVC(new RowGenerator(num_rows, 100, 0, 1), k),
+          first_k(new RowGenerator(num_rows, 100, 0, 1), k, ROW_ARITY), ROW_ARITY);
+}
+
+TEST_F(TopKTest, NoOVC) {
+    size_t num_rows = 100000;
+    size_t k = 300;
+    check(new TopK(new RowGenerator(num_rows, 100, 0, 1), k),
+          first_k(new RowGenerator(num_rows, 100, 0, 1), k, ROW_ARITY), ROW_ARITY, false);
+}
+
+TEST_F(TopKTest, Duplicates) {
+    size_t num_rows = 100000;
+    size_t k = 1000;
+    check(new TopKPrefixOVC(new RowGenerator(num_rows, 4, 0, 1), k, 3),
+          first_k(new RowGenerator(num_rows, 4, 0, 1), k, 3), 3);
+}
+
+TEST_F(TopKTest, DropsRows) {
+    size_t num_rows = 100000;
+    size_t k = 100;
+    auto *plan = new TopKOVC(new RowGenerator(num_rows, 1000, 0, 1), k);
+    plan->run();
+    // rows only enter the queue if they are smaller than the k-th smallest row seen so far
+    ASSERT_LT(plan->getDropped(), num_rows);
+    ASSERT_GT(plan->getDropped(), num_rows / 2);
+    delete plan;
+}
@@ -0,0 +1,130 @@
+#include "lib/Row.h"
+#include "lib/iterators/Window.h"
+#include "lib/iterators/Sort.h"
+#include "lib/iterators/VectorScan.h"
+#include "lib/iterators/AssertEqual.h"
+#include "lib/iterators/OVCApplier.h"
+#include "lib/iterators/RowGenerator.h"
+#include "lib/log.h"
+
+#include <gtest/gtest.h>
+
+using namespace ovc;
+using namespace iterators;
+using namespace window;
+
+class WindowTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log_set_quiet(false);
+        log_set_level(LOG_ERROR);
+    }
+
+    void TearDown() override {
+    }
+};
+
+static Iterator *input() {
+    return new VectorScan({
+                                  {0, 0, {1, 1, 10}},
+                                  {0, 0, {1, 1, 20}},
+                                  {0, 0, {1, 2, 5}},
+                                  {0, 0, {1, 4, 1}},
+                                  {0, 0, {2, 1, 7}},
+                                  {0, 0, {2, 3, 3}},
+                                  {0, 0, {2, 3, 4}},
+                          });
+}
+
+static Iterator *expected() {
+    return new VectorScan({
+                                  {0, 0, {1, 1, 10, 1, 1, 1, 10}},
+                                  {0, 0, {1, 1, 20, 2, 1, 1, 30}},
+                                  {0, 0, {1, 2, 5, 3, 3, 2, 35}},
+                                  {0, 0, {1, 4, 1, 4, 4, 3, 36}},
+                                  {0, 0, {2, 1, 7, 1, 1, 1, 7}},
+                                  {0, 0, {2, 3, 3, 2, 2, 2, 10}},
+                                  {0, 0, {2, 3, 4, 3, 2, 2, 14}},
+                          });
+}
+
+TEST_F(WindowTest, EmptyTest) {
+    auto *plan = new AssertEqual(
+            new WindowOVC<RowNumber<3>>(new VectorScan({}), 1, 1),
+            new VectorScan({})
+    );
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(WindowTest, Simple) {
+    auto *plan = new AssertEqual(
+            new Window<RowNumber<3>, Rank<4>, DenseRank<5>, Running<aggregates::fused::Sum<2>, 6>>(input(), 1, 1),
+            expected()
+    );
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(WindowTest, OVCSimple) {
+    auto *plan = new AssertEqual(
+            new WindowOVC<RowNumber<3>, Rank<4>, DenseRank<5>, Running<aggregates::fused::Sum<2>, 6>>(
+                    new OVCApplier(input(), 2), 1, 1),
+            expected()
+    );
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(WindowTest, NoPartitions) {
+    auto *plan = new AssertEqual(
+            new WindowOVC<Rank<3>, DenseRank<4>, Running<aggregates::fused::Max<2>, 5>>(
+                    new OVCApplier(input(), 2), 0, 2),
+            new VectorScan({
+                                   {0, 0, {1, 1, 10, 1, 1, 10}},
+                                   {0, 0, {1, 1, 20, 1, 1, 20}},
+                                   {0, 0, {1, 2, 5, 3, 2, 20}},
+                                   {0, 0, {1, 4, 1, 4, 3, 20}},
+                                   {0, 0, {2, 1, 7, 5, 4, 20}},
+                                   {0, 0, {2, 3, 3, 6, 5, 20}},
+                                   {0, 0, {2, 3, 4, 6, 5, 20}},
+                           })
+    );
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(WindowTest, OVCAgreesWithColumns) {
+    size_t num_rows = 100000;
+    typedef aggregates::fused::Count C;
+    auto *plan = new AssertEqual(
+            new WindowOVC<RowNumber<20>, Rank<21>, DenseRank<22>, Running<C, 23>>(
+                    new SortPrefixOVC(new RowGenerator(num_rows, 8, 0, 1), 3), 1, 2),
+            new Window<RowNumber<20>, Rank<21>, DenseRank<22>, Running<C, 23>>(
+                    new SortPrefixOVC(new RowGenerator(num_rows, 8, 0, 1), 3), 1, 2)
+    );
+    plan->run();
+    ASSERT_TRUE(plan->isEqual());
+    delete plan;
+}
+
+TEST_F(WindowTest, RowNumbersAreComplete) {
+    size_t num_rows = 100000;
+    auto *plan = new WindowOVC<RowNumber<20>, Rank<21>, DenseRank<22>>(
+            new SortPrefixOVC(new RowGenerator(num_rows, 8, 0, 1), 2), 1, 1);
+    plan->open();
+    size_t partitions = 0;
+    for (Row *row; (row = plan->next()); plan->free()) {
+        ASSERT_LE(row->columns[22], row->columns[21]);
+        ASSERT_LE(row->columns[21], row->columns[20]);
+        partitions += row->columns[20] == 1;
+    }
+    plan->close();
+    ASSERT_EQ(plan->getCount(), num_rows);
+    ASSERT_EQ(partitions, 8);
+    delete plan;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace ovc {
+
+    /**
+     * Split block bloom filter. Every key is mapped to a single 64 byte block (one cache line) in which one bit
+     * is set in each of the eight words, so an insert or a lookup touches exactly one cache line.
+     */
+    class BloomFilter {
+    public:
+        explicit BloomFilter(size_t num_keys = 0, size_t bits_per_key = 16) {
+            resize(num_keys, bits_per_key);
+        }
+
+        /**
+         * Discard all keys and size the filter for the given number of keys.
+         */
+        void resize(size_t num_keys, size_t bits_per_key = 16) {
+            size_t num_blocks = (num_keys * bits_per_key + BLOCK_BITS - 1) / BLOCK_BITS;
+            if (num_blocks == 0) {
+                num_blocks = 1;
+            }
+            blocks.assign(num_blocks, Block());
+        }
+
+        void insert(uint64_t hash) {
+            hash = mix(hash);
+            Block &block = blocks[blockIndex(hash)];
+            for (int i = 0; i < BLOCK_WORDS; i++) {
+                block.words[i] |= mask(hash, i);
+            }
+        }
+
+        /**
+         * Returns false if the hash was definitely never inserted.
+         */
+        bool contains(uint64_t hash) const {
+            hash = mix(hash);
+            const Block &block = blocks[blockIndex(hash)];
+            for (int i = 0; i < BLOCK_WORDS; i++) {
+                if (!(block.words[i] & mask(hash, i))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        size_t size() const {
+            return blocks.size() * sizeof(Block);
+        }
+
+    private:
+        static constexpr int BLOCK_WORDS = 8;
+        static constexpr size_t BLOCK_BITS = BLOCK_WORDS * 64;
+
+        struct alignas(64) Block {
+            uint64_t words[BLOCK_WORDS] = {0};
+        };
+
+        std::vector<Block> blocks;
+
+        /**
+         * The low bits of row hashes already select the partition, remix them (murmur3 finalizer) so the block
+         * index and bit positions are independent of the partition.
+         */
+        static inline uint64_t mix(uint64_t h) {
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdul;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ul;
+            h ^= h >> 33;
+            return h;
+        }
+
+        inline size_t blockIndex(uint64_t hash) const {
+            return ((hash >> 32) * blocks.size()) >> 32;
+        }
+
+        static inline uint64_t mask(uint64_t hash, int i) {
+            static constexpr uint32_t salt[BLOCK_WORDS] = {
+                    0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+                    0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u
+            };
+            return 1ul << (((uint32_t) hash * salt[i]) >> 26);
+        }
+    };
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "lib/PriorityQueue.h"
+#include "lib/utils.h"
+#include "lib/io/ExternalRunR.h"
+
+#include <memory>
+#include <vector>
+
+// runs per leaf queue, small enough for a leaf to stay in cache
+#define MERGE_CASCADE_LEAF_RUNS 64
+// leaves per root queue
+#define MERGE_CASCADE_MAX_LEAVES 64
+
+namespace ovc {
+
+    /**
+     * Merges more external runs than fit into a single queue in one pass: leaf queues of at most
+     * MERGE_CASCADE_LEAF_RUNS runs each feed a root queue. A leaf offers its top row to the root without popping it.
+     * The OVC of that row is w.r.t. the last row the leaf emitted, which is also the last row the root emitted, so the
+     * leaves look like sorted runs to the root and OVCs stay valid across both levels. With a single leaf, the root is
+     * bypassed.
+     * Offers the subset of the PriorityQueue interface that is used when merging external runs.
+     */
+    template<typename Compare>
+    class MergeCascade {
+    public:
+        typedef PriorityQueue<Compare> Leaf;
+
+        MergeCascade(iterator_stats *stats, const Compare &cmp)
+                : stats(stats), cmp(cmp), top_queue(QUEUE_CAPACITY, stats, cmp), num_leaves(0) {
+        }
+
+        /**
+         * Start merging the given runs, which must not move until the merge is finished.
+         */
+        void insert(io::ExternalRunR *runs, size_t num_runs) {
+            num_leaves = std::max<size_t>((num_runs + MERGE_CASCADE_LEAF_RUNS - 1) / MERGE_CASCADE_LEAF_RUNS, 1);
+            assert(num_leaves <= MERGE_CASCADE_MAX_LEAVES);
+            while (leaves.size() < num_leaves) {
+                // a queue holds at least QUEUE_CAPACITY slots, the leaf only uses the first MERGE_CASCADE_LEAF_RUNS
+                leaves.push_back(std::make_unique<Leaf>(QUEUE_CAPACITY, stats, cmp));
+            }
+
+            // spread the runs evenly, so that all leaves are equally deep
+            size_t begin = 0;
+            for (size_t i = 0; i < num_leaves; i++) {
+                size_t end = num_runs * (i + 1) / num_leaves;
+                Leaf &leaf = *leaves[i];
+                leaf.clear();
+                leaf.reset(p2(std::max<size_t>(end - begin, 2)));
+                for (size_t j = begin; j < end; j++) {
+                    leaf.push_external(runs[j]);
+                }
+                leaf.flush_sentinels();
+                begin = end;
+            }
+
+            if (num_leaves > 1) {
+                top_queue.clear();
+                top_queue.reset(p2(num_leaves));
+                for (size_t i = 0; i < num_leaves; i++) {
+                    if (!leaves[i]->isEmpty()) {
+                        top_queue.push(leaves[i]->top(), MERGE_RUN_IDX, leaves[i].get());
+                    }
+                }
+                top_queue.flush_sentinels();
+            }
+        }
+
+        inline bool isEmpty() {
+            return num_leaves <= 1 ? num_leaves == 0 || leaves[0]->isEmpty() : top_queue.isEmpty();
+        }
+
+        inline Row *top() {
+            return num_leaves == 1 ? leaves[0]->top() : top_queue.top();
+        }
+
+        inline OVC top_ovc() {
+            return num_leaves == 1 ? leaves[0]->top_ovc() : top_queue.top_ovc();
+        }
+
+        /**
+         * Pop the lowest row, it is valid until the next call.
+         */
+        Row *pop_external() {
+            if (num_leaves == 1) {
+                return leaves[0]->pop_external();
+            }
+
+            auto *leaf = top_queue.template top_udata2<Leaf>();
+            Row *res = top_queue.top();
+            // the leaf must not overwrite the OVC of the row w.r.t. the previous output of the root
+            OVC ovc = res->key;
+            leaf->pop_external();
+
+            if (likely(!leaf->isEmpty())) {
+                Row *next = leaf->top();
+                if (!top_queue.replace_top(next)) {
+                    top_queue.pop();
+                    top_queue.push_next(next);
+                }
+            } else {
+                top_queue.pop();
+                top_queue.flush_sentinel();
+            }
+
+            res->key = ovc;
+            return res;
+        }
+
+        const std::string &top_path() {
+            return num_leaves == 1 ? leaves[0]->top_path() : top_queue.template top_udata2<Leaf>()->top_path();
+        }
+
+        /**
+         * The number of leaf queues of the current merge.
+         */
+        size_t getNumLeaves() const {
+            return num_leaves;
+        }
+
+    private:
+        iterator_stats *stats;
+        Compare cmp;
+        PriorityQueue<Compare> top_queue;
+        std::vector<std::unique_ptr<Leaf>> leaves;
+        size_t num_leaves;
+    };
+}
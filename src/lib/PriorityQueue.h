@@ -11,6 +11,7 @@
 #include <bit>
 #include <stack>
 #include <sstream>
+#include <type_traits>
 
 #define QUEUE_CAPACITY PRIORITYQUEUE_CAPACITY
 #define MERGE_RUN_IDX ((1ul << RUN_IDX_BITS) - 2)
@@ -20,7 +21,13 @@ namespace ovc {
 
     typedef unsigned long Key;
 
-    template<typename Compare>
+    /**
+     * Tree-of-losers priority queue. With PACKED, every node also holds the row pointer and a cached key column, so
+     * that most ties between equal keys are decided without touching the (272 byte) rows: without OVCs the first
+     * sort column is cached, with OVCs the column after the offset. The OVC of a row in the queue is then only
+     * kept in its node and written back to the row when it reaches the top.
+     */
+    template<typename Compare, bool PACKED = false>
     class PriorityQueueBase {
     public:
 
@@ -73,6 +80,11 @@ namespace ovc {
 
         void reset(size_t capacity);
 
+        /**
+         * Discard all rows in the queue and reset it.
+         */
+        void clear();
+
         void pass(Index index, Key key);
 
         /**
@@ -99,6 +111,16 @@ namespace ovc {
 
         OVC top_ovc();
 
+        /**
+         * Replace the lowest row with the next row of its run, if that row still precedes all other rows in the queue.
+         * The losers on the path of the run stay the same then and no pass is needed. The smallest of these losers is
+         * looked up once per pass, afterwards each row costs a single key comparison with OVCs, a single row
+         * comparison otherwise.
+         * @param row The next row of the run of the lowest row.
+         * @return true, if the row was replaced, otherwise the queue is unchanged.
+         */
+        bool replace_top(Row *row);
+
         size_t top_run_idx();
 
         std::string to_string() const;
@@ -109,7 +131,7 @@ namespace ovc {
 
         Row *pop_safe(Index run_index);
 
-        friend std::ostream &operator<<(std::ostream &o, const PriorityQueueBase<Compare> &pq) {
+        friend std::ostream &operator<<(std::ostream &o, const PriorityQueueBase<Compare, PACKED> &pq) {
             for (size_t i = 0; i < pq.getCapacity(); i++) {
                 if (i > 0) {
                     o << std::endl;
@@ -129,25 +151,30 @@ namespace ovc {
     private:
         struct WorkspaceItem;
         struct Node;
+        struct PackedNode;
+        typedef typename std::conditional<PACKED, PackedNode, Node>::type HeapNode;
 
         size_t size; /* number of items in the queue */
         size_t capacity; /* current capacity, always <= max_capacity */
         size_t max_capacity; /* maximal capacity of the queue */
-        Node *heap;
+        HeapNode *heap;
         WorkspaceItem *workspace;
+        Index runner_up; /* slot of the smallest loser on the path of the top node, 0 if unknown */
+
+        void find_runner_up();
     };
 
-    template<typename Compare>
-    class PriorityQueue : public PriorityQueueBase<Compare> {
+    template<typename Compare, bool PACKED = false>
+    class PriorityQueue : public PriorityQueueBase<Compare, PACKED> {
 
     public:
         PriorityQueue(size_t capacity, iterator_stats *stats, const Compare &less = Compare())
-                : PriorityQueueBase<Compare>(capacity, stats, less) {
+                : PriorityQueueBase<Compare, PACKED>(capacity, stats, less) {
         };
 
         template<class T = void>
         inline void push(Row *row, Index run_index, T *udata = nullptr) {
-            PriorityQueueBase<Compare>::push(row, run_index, reinterpret_cast<void *>(udata));
+            PriorityQueueBase<Compare, PACKED>::push(row, run_index, reinterpret_cast<void *>(udata));
         }
 
         template<class T = void>
@@ -200,26 +227,62 @@ namespace ovc {
          */
         Row *pop_memory() {
             auto *run = this->template top_udata2<MemoryRun>();
-            Row *res = this->pop();
+            Row *res = this->top();
             run->next();
 
             if (likely(run->size() > 0)) {
-                this->push_next(run->front());
+                if (!this->replace_top(run->front())) {
+                    this->pop();
+                    this->push_next(run->front());
+                }
             } else {
+                this->pop();
                 this->flush_sentinel();
             }
 
             return res;
         }
 
+        /**
+         * Pop the lowest row and all following rows of its in-memory run that precede every other row in the queue.
+         * The rows keep their OVCs, which are w.r.t. their predecessor in the run and thus in the output.
+         * @param span Set to the first of the rows, which are consecutive in the run.
+         * @return The number of rows.
+         */
+        size_t pop_memory_span(Row **&span) {
+            auto *run = this->template top_udata2<MemoryRun>();
+            this->top();
+            span = &run->data[run->ind];
+            run->next();
+            size_t n = 1;
+
+            while (run->size() > 0 && this->replace_top(run->front())) {
+                run->next();
+                n++;
+            }
+
+            this->pop();
+            if (likely(run->size() > 0)) {
+                this->push_next(run->front());
+            } else {
+                this->flush_sentinel();
+            }
+
+            return n;
+        }
+
         Row *pop_memory2() {
             auto run = this->template top_udata2<std::tuple<Row **,Row **>>();
-            Row *res = this->pop();
+            Row *res = this->top();
             std::get<0>(*run)++;
 
             if (likely(std::get<0>(*run) < std::get<1>(*run))) {
-                this->push_next(*std::get<0>(*run));
+                if (!this->replace_top(*std::get<0>(*run))) {
+                    this->pop();
+                    this->push_next(*std::get<0>(*run));
+                }
             } else {
+                this->pop();
                 this->flush_sentinel();
             }
 
@@ -232,7 +295,7 @@ namespace ovc {
          */
         Row *pop_external() {
             auto *run = this->template top_udata2<io::ExternalRunR>();
-            Row *res = this->pop();
+            Row *res = this->top();
             Row *next = run->read();
 
 #ifdef COLLECT_STATS
@@ -240,8 +303,12 @@ namespace ovc {
 #endif
 
             if (likely(next != nullptr)) {
-                this->push_next(next);
+                if (!this->replace_top(next)) {
+                    this->pop();
+                    this->push_next(next);
+                }
             } else {
+                this->pop();
                 this->flush_sentinel();
             }
             return res;
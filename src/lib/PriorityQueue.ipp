@@ -33,16 +33,16 @@
 
 namespace ovc {
 
-    template<typename Compare>
-    struct PriorityQueueBase<Compare>::WorkspaceItem {
+    template<typename Compare, bool PACKED>
+    struct PriorityQueueBase<Compare, PACKED>::WorkspaceItem {
         Row *row;
         void *udata;
 
         WorkspaceItem() = default;
     };
 
-    template<typename Compare>
-    struct PriorityQueueBase<Compare>::Node {
+    template<typename Compare, bool PACKED>
+    struct PriorityQueueBase<Compare, PACKED>::Node {
         /* SortOVC key in this priority queue. */
         node_key_t key;
 
@@ -53,6 +53,8 @@ namespace ovc {
 
         Node(Index index, Key key) : key(key), index(index) {}
 
+        Node(Index index, Key key, Row *row, const Compare &cmp) : key(key), index(index) {}
+
         inline void swap(Node &node) {
             Node tmp = node;
             node = *this;
@@ -134,10 +136,94 @@ namespace ovc {
         }
     };
 
-    template<typename Compare>
-    PriorityQueueBase<Compare>::PriorityQueueBase(size_t max_capacity, iterator_stats *stats, const Compare &cmp)
+    template<typename Compare, bool PACKED>
+    struct PriorityQueueBase<Compare, PACKED>::PackedNode : public Node {
+        Row *row;
+        /* first sort column without OVCs, the column after the offset with OVCs */
+        unsigned long cache;
+        bool has_cache;
+
+        PackedNode() : Node(), row(nullptr), cache(0), has_cache(false) {}
+
+        PackedNode(Index index, Key key, Row *row, const Compare &cmp) : Node(index, key), row(row), cache(0),
+                                                                          has_cache(false) {
+            if (this->isValid()) {
+                refresh(cmp);
+            }
+        }
+
+        inline void swap(PackedNode &node) {
+            PackedNode tmp = node;
+            node = *this;
+            *this = tmp;
+        }
+
+        inline void refresh(const Compare &cmp) {
+            if constexpr (!cmp.USES_OVC) {
+                cache = row->columns[cmp.columns[0]];
+                has_cache = true;
+            } else {
+                unsigned offset = this->getOffset() + 1;
+                has_cache = offset < cmp.length;
+                if (has_cache) {
+                    cache = row->columns[cmp.columns[offset]];
+                }
+            }
+        }
+
+        // sets ovc of the loser w.r.t. the winner
+        inline bool less(PackedNode &node, Compare &cmp, WorkspaceItem *ws, struct iterator_stats *stats) {
+            if (this->key != node.key) {
+                return this->key < node.key;
+            }
+            if constexpr (!cmp.USES_OVC) {
+                if (cache != node.cache) {
+#ifdef COLLECT_STATS
+                    if (stats) {
+                        stats->column_comparisons++;
+                    }
+#endif
+                    return cache < node.cache;
+                }
+                return cmp(*row, *node.row) < 0;
+            } else {
+                if (has_cache && node.has_cache && cache != node.cache) {
+#ifdef COLLECT_STATS
+                    if (stats) {
+                        stats->column_comparisons++;
+                    }
+#endif
+                    // both rows agree up to the offset, the loser now differs at the next column
+                    unsigned offset = this->getOffset() + 1;
+                    if (cache < node.cache) {
+                        node.setOVC(MAKE_OVC(ROW_ARITY, offset, node.cache));
+                        node.has_cache = false;
+                        return true;
+                    } else {
+                        this->setOVC(MAKE_OVC(ROW_ARITY, offset, cache));
+                        has_cache = false;
+                        return false;
+                    }
+                }
+                row->key = this->getOVC();
+                node.row->key = node.getOVC();
+                if (cmp(*row, *node.row) <= 0) {
+                    node.setOVC(node.row->key);
+                    node.refresh(cmp);
+                    return true;
+                } else {
+                    this->setOVC(row->key);
+                    refresh(cmp);
+                    return false;
+                }
+            }
+        }
+    };
+
+    template<typename Compare, bool PACKED>
+    PriorityQueueBase<Compare, PACKED>::PriorityQueueBase(size_t max_capacity, iterator_stats *stats, const Compare &cmp)
             : capacity(max_capacity), max_capacity(max_capacity), size(0), cmp(cmp), stats(stats),
-            workspace(new WorkspaceItem[max_capacity]), heap(new Node[max_capacity]) {
+            workspace(new WorkspaceItem[max_capacity]), heap(new HeapNode[max_capacity]), runner_up(0) {
         assert(std::__popcount(max_capacity) == 1);
         assert(max_capacity >= (1 << RUN_IDX_BITS) - 3);
         for (int i = 0; i < max_capacity; i++) {
@@ -146,8 +232,8 @@ namespace ovc {
         }
     }
 
-    template<typename Compare>
-    bool PriorityQueueBase<Compare>::isCorrect() const {
+    template<typename Compare, bool PACKED>
+    bool PriorityQueueBase<Compare, PACKED>::isCorrect() const {
         for (Index i = 0; i < getCapacity() / 2; i++) {
             for (Index j = getCapacity() / 2 + heap[i].index / 2; j > i; j = parent(j)) {
                 if (!heap[j].isValid()) {
@@ -172,22 +258,22 @@ namespace ovc {
         return true;
     }
 
-    template<typename Compare>
-    PriorityQueueBase<Compare>::~PriorityQueueBase() {
+    template<typename Compare, bool PACKED>
+    PriorityQueueBase<Compare, PACKED>::~PriorityQueueBase() {
         delete[] workspace;
         delete[] heap;
     }
 
-    template<typename Compare>
-    Row *PriorityQueueBase<Compare>::pop_safe(Index run_index) {
+    template<typename Compare, bool PACKED>
+    Row *PriorityQueueBase<Compare, PACKED>::pop_safe(Index run_index) {
         while (heap[0].isLowSentinel()) {
             flush_sentinel(false);
         }
         return pop();
     }
 
-    template<typename Compare>
-    void PriorityQueueBase<Compare>::flush_sentinel(bool safe) {
+    template<typename Compare, bool PACKED>
+    void PriorityQueueBase<Compare, PACKED>::flush_sentinel(bool safe) {
         if (safe) {
             if (heap[0].isLowSentinel()) {
                 pass(heap[0].index, HIGH_SENTINEL(heap[0].index));
@@ -198,8 +284,8 @@ namespace ovc {
         }
     }
 
-    template<typename Compare>
-    void PriorityQueueBase<Compare>::flush_sentinels() {
+    template<typename Compare, bool PACKED>
+    void PriorityQueueBase<Compare, PACKED>::flush_sentinels() {
         for (int i = size; i < capacity; i++) {
             assert(heap[0].isLowSentinel());
             pass(heap[0].index, HIGH_SENTINEL(heap[0].index));
@@ -207,47 +293,106 @@ namespace ovc {
         assert(!heap[0].isLowSentinel());
     }
 
-    template<typename Compare>
-    std::string PriorityQueueBase<Compare>::to_string() const {
+    template<typename Compare, bool PACKED>
+    std::string PriorityQueueBase<Compare, PACKED>::to_string() const {
         std::stringstream stream;
         stream << *this << std::endl;
         return stream.str();
     }
 
-    template<typename Compare>
-    size_t PriorityQueueBase<Compare>::top_run_idx() {
+    template<typename Compare, bool PACKED>
+    size_t PriorityQueueBase<Compare, PACKED>::top_run_idx() {
         assert(!isEmpty());
         assert(!heap[0].isLowSentinel());
         return heap[0].run_index();
     }
 
-    template<typename Compare>
-    void *PriorityQueueBase<Compare>::top_udata() {
+    template<typename Compare, bool PACKED>
+    void *PriorityQueueBase<Compare, PACKED>::top_udata() {
         assert(!isEmpty());
         assert(!heap[0].isLowSentinel());
         return workspace[heap[0].index].udata;
     }
 
-    template<typename Compare>
-    OVC PriorityQueueBase<Compare>::top_ovc() {
+    template<typename Compare, bool PACKED>
+    OVC PriorityQueueBase<Compare, PACKED>::top_ovc() {
         return heap[0].getOVC();
     }
 
-    template<typename Compare>
-    Row *PriorityQueueBase<Compare>::top() {
+    template<typename Compare, bool PACKED>
+    void PriorityQueueBase<Compare, PACKED>::find_runner_up() {
+        runner_up = capacity / 2 + heap[0].index / 2;
+        for (Index slot = parent(runner_up); slot != 0; slot /= 2) {
+            if (heap[slot].key < heap[runner_up].key) {
+                runner_up = slot;
+            } else if constexpr (!cmp.USES_OVC) {
+                // all rows of merged runs have the same key, the earlier loser wins ties as in pass()
+                if (heap[slot].key == heap[runner_up].key && heap[slot].isValid() &&
+                    cmp(*workspace[heap[slot].index].row, *workspace[heap[runner_up].index].row) < 0) {
+                    runner_up = slot;
+                }
+            }
+        }
+    }
+
+    template<typename Compare, bool PACKED>
+    bool PriorityQueueBase<Compare, PACKED>::replace_top(Row *row) {
+        assert(!isEmpty());
+        assert(heap[0].isValid());
+
+        if (runner_up == 0) {
+            find_runner_up();
+        }
+
+        Key key;
+        if constexpr (cmp.USES_OVC) {
+            key = NODE_KEYGEN(heap[0].run_index(), row->key);
+        } else {
+            key = NODE_KEYGEN(heap[0].run_index(), 0);
+        }
+
+        const HeapNode &other = heap[runner_up];
+        if (key == other.key) {
+            if constexpr (cmp.USES_OVC) {
+                // the OVC of one of the rows must be recomputed in a pass
+                return false;
+            } else if (cmp(*row, *workspace[other.index].row) > 0) {
+                return false;
+            }
+        } else if (key > other.key) {
+            return false;
+        }
+
+        // with OVCs, the losers on the path keep their OVCs: they differ from the new row where they differed from
+        // the old one
+        Index index = heap[0].index;
+        workspace[index].row = row;
+        heap[0] = HeapNode(index, key, row, cmp);
+        return true;
+    }
+
+    template<typename Compare, bool PACKED>
+    Row *PriorityQueueBase<Compare, PACKED>::top() {
         assert(!isEmpty());
         assert(!heap[0].isLowSentinel());
-        return workspace[heap[0].index].row;
+        Row *res = workspace[heap[0].index].row;
+        if constexpr (PACKED && cmp.USES_OVC) {
+            res->key = heap[0].getOVC();
+        }
+        return res;
     }
 
-    template<typename Compare>
-    Row *PriorityQueueBase<Compare>::pop() {
+    template<typename Compare, bool PACKED>
+    Row *PriorityQueueBase<Compare, PACKED>::pop() {
         assert(!isEmpty());
         assert(!heap[0].isLowSentinel());
 
         Index workspace_index = heap[0].index;
 
         Row *res = workspace[workspace_index].row;
+        if constexpr (PACKED && cmp.USES_OVC) {
+            res->key = heap[0].getOVC();
+        }
 
         // Replace top node with low sentinel
         heap[0].key = LOW_SENTINEL(workspace_index);
@@ -257,13 +402,16 @@ namespace ovc {
         return res;
     }
 
-    template<typename Compare>
-    Row *PriorityQueueBase<Compare>::popf() {
+    template<typename Compare, bool PACKED>
+    Row *PriorityQueueBase<Compare, PACKED>::popf() {
         assert(!isEmpty());
         assert(!heap[0].isLowSentinel());
 
         Index workspace_index = heap[0].index;
         Row *res = workspace[workspace_index].row;
+        if constexpr (PACKED && cmp.USES_OVC) {
+            res->key = heap[0].getOVC();
+        }
 
         //workspace[workspace_index].row = nullptr;
 
@@ -273,8 +421,8 @@ namespace ovc {
         return res;
     }
 
-    template<typename Compare>
-    void PriorityQueueBase<Compare>::push(Row *row, Index run_index, void *udata) {
+    template<typename Compare, bool PACKED>
+    void PriorityQueueBase<Compare, PACKED>::push(Row *row, Index run_index, void *udata) {
         assert(size < capacity);
         assert(heap[0].isLowSentinel());
         assert(row != nullptr);
@@ -291,8 +439,8 @@ namespace ovc {
         size++;
     }
 
-    template<typename Compare>
-    void PriorityQueueBase<Compare>::push_next(Row *row) {
+    template<typename Compare, bool PACKED>
+    void PriorityQueueBase<Compare, PACKED>::push_next(Row *row) {
         assert(size < capacity);
         assert(heap[0].isLowSentinel());
         assert(row != nullptr);
@@ -307,9 +455,10 @@ namespace ovc {
         size++;
     }
 
-    template<typename Compare>
-    void PriorityQueueBase<Compare>::pass(Index index, Key key) {
-        Node candidate(index, key);
+    template<typename Compare, bool PACKED>
+    void PriorityQueueBase<Compare, PACKED>::pass(Index index, Key key) {
+        runner_up = 0;
+        HeapNode candidate(index, key, workspace[index].row, cmp);
         for (Index slot = capacity / 2 + index / 2; slot != 0; slot /= 2) {
             if (heap[slot].less(candidate, cmp, workspace, stats)) {
                 heap[slot].swap(candidate);
@@ -318,22 +467,29 @@ namespace ovc {
         heap[0] = candidate;
     }
 
-    template<typename Compare>
-    void PriorityQueueBase<Compare>::reset(size_t capacity_) {
+    template<typename Compare, bool PACKED>
+    void PriorityQueueBase<Compare, PACKED>::reset(size_t capacity_) {
         assert(isEmpty());
         assert(capacity <= max_capacity);
         if (getCapacity() != capacity_) {
             log_trace("resized queue from %lu to %lu", getCapacity(), capacity_);
         }
         capacity = capacity_;
+        runner_up = 0;
         for (int i = 0; i < capacity_; i++) {
             heap[i].key = LOW_SENTINEL(i);
             heap[i].index = i;
         }
     }
 
-    template<typename Compare>
-    void PriorityQueueBase<Compare>::reset() {
+    template<typename Compare, bool PACKED>
+    void PriorityQueueBase<Compare, PACKED>::reset() {
+        reset(this->capacity);
+    }
+
+    template<typename Compare, bool PACKED>
+    void PriorityQueueBase<Compare, PACKED>::clear() {
+        size = 0;
         reset(this->capacity);
     }
 }
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "defs.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace ovc {
+
+    /**
+     * Offset-value codes with range-maximum queries, kept in a bottom-up segment tree. Queries take O(log n), the tree
+     * needs 2n codes. Codes can be appended at any time and become visible to queries after the next call to build(),
+     * which only updates the part of the tree above the new codes.
+     */
+    class RangeMax {
+    public:
+        RangeMax() : capacity(0), num_values(0), num_built(0) {}
+
+        void push_back(OVC ovc) {
+            if (num_values == capacity) {
+                grow();
+            }
+            tree[capacity + num_values++] = ovc;
+        }
+
+        OVC operator[](size_t i) const {
+            assert(i < num_values);
+            return tree[capacity + i];
+        }
+
+        size_t size() const {
+            return num_values;
+        }
+
+        bool empty() const {
+            return num_values == 0;
+        }
+
+        /**
+         * Remove all codes. Stale nodes don't need to be reset, a query only visits nodes within its range.
+         */
+        void clear() {
+            num_values = 0;
+            num_built = 0;
+        }
+
+        /**
+         * Update the inner nodes above codes appended since the last call.
+         */
+        void build() {
+            if (num_built == num_values) {
+                return;
+            }
+            size_t lo = (capacity + num_built) / 2;
+            size_t hi = (capacity + num_values - 1) / 2;
+            for (; lo > 0; lo /= 2, hi /= 2) {
+                for (size_t i = lo; i <= hi; i++) {
+                    tree[i] = std::max(tree[2 * i], tree[2 * i + 1]);
+                }
+            }
+            num_built = num_values;
+        }
+
+        /**
+         * The largest code in [begin, end), 0 if the range is empty.
+         */
+        OVC max(size_t begin, size_t end) const {
+            assert(end <= num_built);
+            OVC res = 0;
+            for (begin += capacity, end += capacity; begin < end; begin /= 2, end /= 2) {
+                if (begin & 1) {
+                    res = std::max(res, tree[begin++]);
+                }
+                if (end & 1) {
+                    res = std::max(res, tree[--end]);
+                }
+            }
+            return res;
+        }
+
+    private:
+        size_t capacity; // number of leaves, a power of two
+        size_t num_values;
+        size_t num_built; // codes covered by the inner nodes
+        std::vector<OVC> tree; // inner nodes at [1, capacity), codes at [capacity, 2 * capacity)
+
+        void grow() {
+            size_t new_capacity = capacity ? capacity * 2 : 64;
+            std::vector<OVC> new_tree(2 * new_capacity);
+            std::copy(tree.begin() + capacity, tree.begin() + capacity + num_values, new_tree.begin() + new_capacity);
+            tree.swap(new_tree);
+            capacity = new_capacity;
+            num_built = 0;
+        }
+    };
+}
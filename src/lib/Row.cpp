@@ -23,8 +23,10 @@ namespace ovc {
 /*
  * https://en.m.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
  */
-    static inline uint64_t hashl(const char *buf, size_t l) {
-        uint64_t h = 0xcbf29ce484222325;
+    static const uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325;
+
+    // pass the previous hash as `h` to continue hashing
+    static inline uint64_t hashl(const char *buf, size_t l, uint64_t h = FNV_OFFSET_BASIS) {
         for (size_t i = 0; i < l; i++) {
             h = (h ^ buf[i]) * 0x00000100000001b3;
         }
@@ -50,4 +52,17 @@ namespace ovc {
 
         return key;
     }
+
+    unsigned long Row::setHash(const uint8_t *hash_columns, int length) {
+        key = calcHash(hash_columns, length);
+        return key;
+    }
+
+    unsigned long Row::calcHash(const uint8_t *hash_columns, int length) const {
+        uint64_t h = FNV_OFFSET_BASIS;
+        for (int i = 0; i < length; i++) {
+            h = hashl((const char *) &columns[hash_columns[i]], sizeof columns[0], h);
+        }
+        return h;
+    }
 }
\ No newline at end of file
@@ -88,8 +88,18 @@ namespace ovc {
 
         unsigned long setHash(int hash_columns = ROW_ARITY);
 
+        /**
+         * Hash the given columns in order, for the columns 0..n-1 this is the same as setHash(n).
+         */
+        unsigned long setHash(const uint8_t *hash_columns, int length);
+
         unsigned long calcHash(int hash_columns = ROW_ARITY);
 
+        /**
+         * Same as setHash(hash_columns, length), without setting the key.
+         */
+        unsigned long calcHash(const uint8_t *hash_columns, int length) const;
+
         /**
          * Get a string representation (in a statically allocated buffer).
          * @return The string.
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Row.h"
+
+namespace ovc {
+
+    /**
+     * In-memory hash table for build sides of hash joins. Rows are expected to carry their hash in the `key` field.
+     * Rows are appended with `insert` and become visible to probes after `build`, which sizes the bucket array to
+     * the next power of two of twice the number of rows and chains rows through an index array.
+     */
+    class RowHashTable {
+    public:
+        RowHashTable() : shift(64) {}
+
+        void insert(const Row &row) {
+            rows.push_back(row);
+        }
+
+        void build() {
+            unsigned bits = 1;
+            while ((1ul << bits) < 2 * rows.size()) {
+                bits++;
+            }
+            shift = 64 - bits;
+            heads.assign(1ul << bits, NIL);
+            chain.resize(rows.size());
+            for (uint32_t i = 0; i < rows.size(); i++) {
+                uint64_t b = bucket(rows[i].key);
+                chain[i] = heads[b];
+                heads[b] = i;
+            }
+        }
+
+        /**
+         * Find the first row with the same hash that is equal to the given row, or the next one after `prev`.
+         */
+        template<typename Equal>
+        const Row *find(const Row &row, Equal &eq, const Row *prev = nullptr) const {
+            if (rows.empty()) {
+                return nullptr;
+            }
+            uint32_t i = prev ? chain[prev - rows.data()] : heads[bucket(row.key)];
+            for (; i != NIL; i = chain[i]) {
+                if (rows[i].key == row.key && eq(row, rows[i])) {
+                    return &rows[i];
+                }
+            }
+            return nullptr;
+        }
+
+        void clear() {
+            rows.clear();
+            heads.clear();
+            chain.clear();
+        }
+
+        size_t size() const {
+            return rows.size();
+        }
+
+        bool empty() const {
+            return rows.empty();
+        }
+
+    private:
+        static constexpr uint32_t NIL = UINT32_MAX;
+
+        std::vector<Row> rows;
+        std::vector<uint32_t> heads;
+        std::vector<uint32_t> chain;
+        unsigned shift;
+
+        /**
+         * Fibonacci hashing, the low bits of the hash are shared by all rows of a partition.
+         */
+        inline uint64_t bucket(uint64_t hash) const {
+            return (hash * 0x9e3779b97f4a7c15ul) >> shift;
+        }
+    };
+}
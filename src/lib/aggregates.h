@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <utility>
 #include "Row.h"
 
 namespace ovc::aggregates {
@@ -131,4 +133,218 @@ namespace ovc::aggregates {
         const int group_columns;
         const int agg_column;
     };
-}
\ No newline at end of file
+
+    /**
+     * Wraps an aggregate so that its rows are never finalized, e.g. to feed partial aggregates of a group-by into an
+     * operator that merges them further.
+     */
+    template<typename Aggregate>
+    struct Partial : public Aggregate {
+        explicit Partial(const Aggregate &agg) : Aggregate(agg) {}
+
+        inline void finalize(Row &row) const {
+        }
+    };
+
+    /**
+     * Parts of a composite aggregate, see Aggregates. A part reads its input value from the row, and keeps its
+     * state in WIDTH consecutive columns.
+     */
+    namespace fused {
+
+        template<int COLUMN>
+        struct Sum {
+            static constexpr int WIDTH = 1;
+
+            static inline unsigned long input(const Row &row) {
+                return row.columns[COLUMN];
+            }
+
+            static inline void init(unsigned long *state, unsigned long value) {
+                state[0] = value;
+            }
+
+            static inline void merge(unsigned long *acc, const unsigned long *state) {
+                acc[0] += state[0];
+            }
+
+            static inline void finalize(unsigned long *state) {
+            }
+        };
+
+        template<int COLUMN>
+        struct Min {
+            static constexpr int WIDTH = 1;
+
+            static inline unsigned long input(const Row &row) {
+                return row.columns[COLUMN];
+            }
+
+            static inline void init(unsigned long *state, unsigned long value) {
+                state[0] = value;
+            }
+
+            static inline void merge(unsigned long *acc, const unsigned long *state) {
+                if (state[0] < acc[0]) {
+                    acc[0] = state[0];
+                }
+            }
+
+            static inline void finalize(unsigned long *state) {
+            }
+        };
+
+        template<int COLUMN>
+        struct Max {
+            static constexpr int WIDTH = 1;
+
+            static inline unsigned long input(const Row &row) {
+                return row.columns[COLUMN];
+            }
+
+            static inline void init(unsigned long *state, unsigned long value) {
+                state[0] = value;
+            }
+
+            static inline void merge(unsigned long *acc, const unsigned long *state) {
+                if (state[0] > acc[0]) {
+                    acc[0] = state[0];
+                }
+            }
+
+            static inline void finalize(unsigned long *state) {
+            }
+        };
+
+        /**
+         * Keeps sum and count, the second column is zero after finalize.
+         */
+        template<int COLUMN>
+        struct Avg {
+            static constexpr int WIDTH = 2;
+
+            static inline unsigned long input(const Row &row) {
+                return row.columns[COLUMN];
+            }
+
+            static inline void init(unsigned long *state, unsigned long value) {
+                state[0] = value;
+                state[1] = 1;
+            }
+
+            static inline void merge(unsigned long *acc, const unsigned long *state) {
+                acc[0] += state[0];
+                acc[1] += state[1];
+            }
+
+            static inline void finalize(unsigned long *state) {
+                state[0] = state[0] / state[1];
+                state[1] = 0;
+            }
+        };
+
+        struct Count {
+            static constexpr int WIDTH = 1;
+
+            static inline unsigned long input(const Row &row) {
+                return 0;
+            }
+
+            static inline void init(unsigned long *state, unsigned long value) {
+                state[0] = 1;
+            }
+
+            static inline void merge(unsigned long *acc, const unsigned long *state) {
+                acc[0] += state[0];
+            }
+
+            static inline void finalize(unsigned long *state) {
+            }
+        };
+
+        template<typename... Parts>
+        constexpr std::array<int, sizeof...(Parts)> offsets() {
+            std::array<int, sizeof...(Parts)> res{};
+            const int widths[] = {Parts::WIDTH...};
+            int offset = 0;
+            for (size_t i = 0; i < sizeof...(Parts); i++) {
+                res[i] = offset;
+                offset += widths[i];
+            }
+            return res;
+        }
+    }
+
+    /**
+     * Computes several aggregates in one pass, e.g. Aggregates<fused::Sum<3>, fused::Min<4>, fused::Count>.
+     * The states of the parts are stored one after another starting at `group_columns`, the remaining columns are
+     * zeroed. The calls to the parts are expanded at compile time, their offsets are constants.
+     */
+    template<typename... Parts>
+    struct Aggregates {
+        static_assert(sizeof...(Parts) > 0, "at least one aggregate is required");
+        static_assert((Parts::WIDTH + ...) < ROW_ARITY, "aggregates do not fit into a row");
+
+        static const bool IS_NULL = false;
+        static constexpr int WIDTH = (Parts::WIDTH + ...);
+
+        explicit Aggregates(int groupColumns) : Aggregates(groupColumns, true) {
+        }
+
+        Aggregates() = delete;
+
+        inline void init(Row &row) const {
+            // read all inputs first, the states may overwrite input columns of later parts
+            const unsigned long values[] = {Parts::input(row)...};
+            init(row, values, std::index_sequence_for<Parts...>());
+            if (clear_rest) {
+                for (int i = group_columns + WIDTH; i < ROW_ARITY; i++) {
+                    row.columns[i] = 0;
+                }
+            }
+        }
+
+        inline void merge(Row &acc, const Row &row) const {
+            merge(acc, row, std::index_sequence_for<Parts...>());
+        }
+
+        inline void finalize(Row &row) const {
+            finalize(row, std::index_sequence_for<Parts...>());
+        }
+
+    protected:
+        Aggregates(int outColumn, bool clearRest) : group_columns(outColumn), clear_rest(clearRest) {
+            assert(group_columns + WIDTH <= ROW_ARITY);
+        }
+
+    private:
+        static constexpr std::array<int, sizeof...(Parts)> OFFSETS = fused::offsets<Parts...>();
+
+        const int group_columns;
+        const bool clear_rest;
+
+        template<size_t... I>
+        inline void init(Row &row, const unsigned long *values, std::index_sequence<I...>) const {
+            (Parts::init(row.columns + group_columns + OFFSETS[I], values[I]), ...);
+        }
+
+        template<size_t... I>
+        inline void merge(Row &acc, const Row &row, std::index_sequence<I...>) const {
+            (Parts::merge(acc.columns + group_columns + OFFSETS[I], row.columns + group_columns + OFFSETS[I]), ...);
+        }
+
+        template<size_t... I>
+        inline void finalize(Row &row, std::index_sequence<I...>) const {
+            (Parts::finalize(row.columns + group_columns + OFFSETS[I]), ...);
+        }
+    };
+
+    /**
+     * Like Aggregates, but the states start at `out_column` and all other columns keep the values of the row that
+     * starts the group. For grouping on column lists, where the group columns are not a prefix of the row.
+     */
+    template<typename... Parts>
+    struct AggregatesAt : public Aggregates<Parts...> {
+        explicit AggregatesAt(int outColumn) : Aggregates<Parts...>(outColumn, false) {}
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Row.h"
+#include "RangeMax.h"
 
 namespace ovc::comparators {
 
@@ -83,9 +84,9 @@ namespace ovc::comparators {
                 return cmp;
             }
 
+            // equal indexes occur for parts of a run that was split when spilling, the rows are equal
             int ind_l = lhs.tid;
             int ind_r = rhs.tid;
-            assert(ind_l - ind_r);
             return ind_l - ind_r;
         }
 
@@ -175,6 +176,13 @@ namespace ovc::comparators {
             return 0;
         }
 
+        /**
+         * Same as raw(), but counts the column comparisons like operator() does.
+         */
+        long rawCounted(const ovc::Row &lhs, const ovc::Row &rhs) const {
+            return (*this)(lhs, rhs);
+        }
+
         inline unsigned long makeOVC(long arity, long offset, const ovc::Row *row) const {
             log_error("makeOVC called on CmpPrefix");
             assert(false);
@@ -311,6 +319,36 @@ namespace ovc::comparators {
             }
             return 0;
         }
+
+        /**
+         * Same as raw(), but counts the column comparisons like operator() does.
+         */
+        long rawCounted(const ovc::Row &lhs, const ovc::Row &rhs, unsigned long *ovc = nullptr) const {
+            for (int i = 0; i < length; i++) {
+                uint8_t ind = columns[i];
+                long cmp = (long) lhs.columns[ind] - (long) rhs.columns[ind];
+
+#ifdef COLLECT_STATS
+                if (stats) {
+                    stats->column_comparisons++;
+                }
+#endif
+                if (cmp != 0) {
+                    if (ovc) {
+                        if (cmp < 0) {
+                            *ovc = MAKE_OVC(ROW_ARITY, i, rhs.columns[ind]);
+                        } else {
+                            *ovc = MAKE_OVC(ROW_ARITY, i, lhs.columns[ind]);
+                        }
+                    }
+                    return cmp;
+                }
+            }
+            if (ovc) {
+                *ovc = 0;
+            }
+            return 0;
+        }
     };
 
     struct CmpPrefixOVC : public CmpColumnListOVC {
@@ -336,7 +374,7 @@ namespace ovc::comparators {
         int length;
         struct iterator_stats *stats;
         static const bool USES_OVC = true;
-        OVC *stored_ovcs;
+        const ovc::RangeMax *stored_ovcs; // ovcs of the first rows of all runs in the segment
         int length_ac;
         int length_c;
     private:
@@ -477,24 +515,18 @@ namespace ovc::comparators {
                 // Equality on AC, derive the offset-value code from stored_ovcs
                 int ind_l = lhs.tid;
                 int ind_r = rhs.tid;
-                if (ind_l < ind_r) {
-                    unsigned long max = 0;
-                    for (int j = ind_l + 1; j <= ind_r; j++) {
-                        if (stored_ovcs[j] > max) {
-                            max = stored_ovcs[j];
-                        }
-                    }
+                if (ind_l == ind_r) {
+                    // parts of the same run that was split when spilling, rows are equal
+                    rhs.key = 0;
+                    return 0;
+                } else if (ind_l < ind_r) {
+                    unsigned long max = stored_ovcs->max(ind_l + 1, ind_r + 1);
                     // increment offset of max by |C|
                     max = OVC_SET_OFFSET(max, OVC_GET_OFFSET(max, ROW_ARITY) + length_c, ROW_ARITY);
                     rhs.key = max;
                     return -1;
                 } else {
-                    unsigned long max = 0;
-                    for (int j = ind_r + 1; j <= ind_l; j++) {
-                        if (stored_ovcs[j] > max) {
-                            max = stored_ovcs[j];
-                        }
-                    }
+                    unsigned long max = stored_ovcs->max(ind_r + 1, ind_l + 1);
                     // increment offset of max by |C|
                     max = OVC_SET_OFFSET(max, OVC_GET_OFFSET(max, ROW_ARITY) + length_c, ROW_ARITY);
                     lhs.key = max;
@@ -546,6 +578,24 @@ namespace ovc::comparators {
             return true;
         }
 
+        /**
+         * Position of the first column in the list in which the rows differ, `length` if they are equal.
+         */
+        int offset(const ovc::Row &lhs, const ovc::Row &rhs) const {
+            int i = 0;
+            for (; i < length; i++) {
+#ifdef COLLECT_STATS
+                if (stats) {
+                    stats->column_comparisons++;
+                }
+#endif
+                if (lhs.columns[columns[i]] != rhs.columns[columns[i]]) {
+                    break;
+                }
+            }
+            return i;
+        }
+
         bool raw(const ovc::Row &lhs, const ovc::Row &rhs) const {
             for (int i = 0; i < length; i++) {
                 if (lhs.columns[columns[i]] != rhs.columns[columns[i]]) {
@@ -2,13 +2,15 @@
 #include "lib/log.h"
 #include "lib/utils.h"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 
 namespace ovc::io {
 
-    BufferManager::BufferManager(size_t capacity) : ring(), loading(), completed(), capacity(capacity) {
-        if (io_uring_queue_init(512, &ring, 0) < 0) {
+    BufferManager::BufferManager(size_t capacity) : ring(), loading(), completed(), capacity(capacity), free(capacity) {
+        // every buffer can have a read in flight
+        if (io_uring_queue_init(p2(std::max<size_t>(capacity, 512)), &ring, 0) < 0) {
             throw std::runtime_error("error initializing io_uring");
         }
 
@@ -42,12 +44,14 @@ namespace ovc::io {
     }
 
     void BufferManager::read(int fd, Buffer *buffer, size_t &offset) {
-        assert(fd < MAX_DESCRIPTORS);
         assert(offset % BUFFER_ALIGNMENT == 0);
 
         if (fd > max_fd) {
             max_fd = fd;
         }
+        if (fd >= completed.size()) {
+            completed.resize(fd + 1);
+        }
 
         if (loading.find(fd) != loading.end()) {
             // TODO: this means we are already loading in the file, preload something else with the new buffer
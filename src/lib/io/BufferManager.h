@@ -5,10 +5,9 @@
 #include <liburing.h>
 #include <stdexcept>
 #include <map>
+#include <vector>
 #include <cassert>
 
-// TODO: we need to raise the file descriptor limit if we actually want to merge 1024 memory_runs
-#define MAX_DESCRIPTORS 1024
 #define PAGES_MAX 1024
 
 namespace ovc::io {
@@ -23,12 +22,12 @@ namespace ovc::io {
         std::map<int, Buffer *> loading;
 
         // completed[fd] == true iff the last next has completed (successfull or not). The buffer is retrieved from
-        // the loading map
-        bool completed[MAX_DESCRIPTORS];
+        // the loading map. Grows with the largest descriptor that was read.
+        std::vector<bool> completed;
 
         size_t capacity;
-        uint16_t free[PAGES_MAX];
-        uint16_t free_ptr;
+        std::vector<size_t> free;
+        size_t free_ptr;
         uint8_t *buffers_raw;
         Buffer *buffers_aligned;
 
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "HashGroupBy.h"
+#include "Sort.h"
+#include "lib/aggregates.h"
+#include "lib/comparators.h"
+
+// Switch to hash aggregation if the first external run holds more than this fraction of the consumed rows
+#define ADAPTIVE_GROUP_BY_MAX_RATIO 0.5
+
+namespace ovc::iterators {
+    using namespace ovc::comparators;
+
+    typedef enum GroupByStrategy {
+        IN_SORT,
+        HASH,
+    } GroupByStrategy;
+
+    /**
+     * Grouping and aggregation that starts out as in-sort aggregation (see InSortGroupBy) and observes the
+     * reduction achieved while generating the first external run. If the consumer does not need sorted output and
+     * the run holds more than `max_ratio` of the consumed rows, i.e. most groups are still unique within a full
+     * workspace, the run and the rest of the input are hash partitioned as in HashGroupBy instead, which saves the
+     * merge passes of the external sort. Sorted output carries OVCs w.r.t. the group columns if Compare uses them.
+     */
+    template<typename Aggregate, typename Compare>
+    class AdaptiveGroupByBase : public HashGroupBy<Aggregate> {
+    public:
+        AdaptiveGroupByBase(Iterator *input, int group_columns, bool sorted_output, const Aggregate &agg,
+                            const Compare &cmp, double max_ratio)
+                : HashGroupBy<Aggregate>(input, group_columns, agg), sorter(&this->stats, cmp, agg),
+                  sorted_output(sorted_output), max_ratio(max_ratio), strategy(IN_SORT) {
+        }
+
+        void open() override {
+            Iterator::open();
+            this->input->open();
+
+            bool has_more_input = sorter.consume_run(this->input);
+            if (!has_more_input || sorted_output || sorter.getRunRatio() <= max_ratio) {
+                while (has_more_input) {
+                    has_more_input = sorter.consume_run(this->input);
+                }
+                this->input->close();
+                sorter.merge_runs();
+                return;
+            }
+
+            log_trace("AdaptiveGroupBy: run ratio %f, switching to hash aggregation", sorter.getRunRatio());
+            strategy = HASH;
+
+            Partitioner partitioner(1 << RUN_IDX_BITS);
+
+            // rows of the external run are aggregated already
+            while (!sorter.external_run_paths.empty()) {
+                io::ExternalRunR run(sorter.external_run_paths.front(), this->bufferManager);
+                sorter.external_run_paths.pop();
+                for (Row *row; (row = run.read());) {
+                    this->stats.rows_read++;
+                    row->setHash(this->columns, this->group_columns);
+                    partitioner.put(row);
+                }
+                run.remove();
+            }
+            sorter.cleanup();
+
+            for (Row *row; (row = this->input->next()); this->input->free()) {
+                this->agg.init(*row);
+                row->setHash(this->columns, this->group_columns);
+                partitioner.put(row);
+            }
+            this->input->close();
+            this->start(partitioner);
+        }
+
+        Row *next() override {
+            if (strategy == HASH) {
+                return HashGroupBy<Aggregate>::next();
+            }
+            if (sorter.cascade.isEmpty()) {
+                return nullptr;
+            }
+            this->count++;
+            return sorter.next();
+        }
+
+        void close() override {
+            HashGroupBy<Aggregate>::close();
+            sorter.cleanup();
+        }
+
+        GroupByStrategy getStrategy() const {
+            return strategy;
+        }
+
+    private:
+        Sorter<false, Compare, Aggregate> sorter;
+        bool sorted_output;
+        double max_ratio;
+        GroupByStrategy strategy;
+    };
+
+    template<typename Aggregate>
+    class AdaptiveGroupByOVC : public AdaptiveGroupByBase<Aggregate, CmpPrefixOVC> {
+    public:
+        AdaptiveGroupByOVC(Iterator *input, int groupColumns, bool sortedOutput, const Aggregate &agg = Aggregate(),
+                           double maxRatio = ADAPTIVE_GROUP_BY_MAX_RATIO)
+                : AdaptiveGroupByBase<Aggregate, CmpPrefixOVC>(input, groupColumns, sortedOutput, agg,
+                                                               CmpPrefixOVC(groupColumns, &this->stats),
+                                                               maxRatio) {};
+    };
+
+    template<typename Aggregate>
+    class AdaptiveGroupBy : public AdaptiveGroupByBase<Aggregate, CmpPrefix> {
+    public:
+        AdaptiveGroupBy(Iterator *input, int groupColumns, bool sortedOutput, const Aggregate &agg = Aggregate(),
+                        double maxRatio = ADAPTIVE_GROUP_BY_MAX_RATIO)
+                : AdaptiveGroupByBase<Aggregate, CmpPrefix>(input, groupColumns, sortedOutput, agg,
+                                                            CmpPrefix(groupColumns, &this->stats), maxRatio) {};
+    };
+}
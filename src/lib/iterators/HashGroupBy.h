@@ -3,6 +3,7 @@
 #include <unordered_map>
 #include "Iterator.h"
 #include "lib/io/ExternalRunR.h"
+#include "lib/Partitioner.h"
 
 namespace ovc::iterators {
 
@@ -11,6 +12,11 @@ namespace ovc::iterators {
     public:
         HashGroupBy(Iterator *input, int group_columns, const Aggregate &agg = Aggregate());
 
+        /**
+         * Group on the given list of columns.
+         */
+        HashGroupBy(Iterator *input, const uint8_t *group_columns, int length, const Aggregate &agg = Aggregate());
+
         void open() override;
 
         Row *next() override;
@@ -21,8 +27,9 @@ namespace ovc::iterators {
             return count;
         }
 
-    private:
+    protected:
         Aggregate agg;
+        uint8_t columns[ROW_ARITY];
         int group_columns;
         std::vector<std::string> partitions;
         io::BufferManager bufferManager;
@@ -31,6 +38,11 @@ namespace ovc::iterators {
         unsigned long count;
 
         std::vector<Row> process_partition(const std::string &path);
+
+        /**
+         * Take over the partitions of the hashed input rows, whose aggregates must already be initialized.
+         */
+        void start(Partitioner &partitioner);
     };
 }
 
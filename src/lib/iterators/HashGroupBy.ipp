@@ -9,6 +9,17 @@ namespace ovc::iterators {
     template<typename Aggregate>
     HashGroupBy<Aggregate>::HashGroupBy(Iterator *input, int group_columns, const Aggregate &agg)
             : UnaryIterator(input), group_columns(group_columns), ind(0), agg(agg), count(0) {
+        for (int i = 0; i < group_columns; i++) {
+            columns[i] = i;
+        }
+    }
+
+    template<typename Aggregate>
+    HashGroupBy<Aggregate>::HashGroupBy(Iterator *input, const uint8_t *group_columns, int length,
+                                        const Aggregate &agg)
+            : UnaryIterator(input), group_columns(length), ind(0), agg(agg), count(0) {
+        assert(length <= ROW_ARITY);
+        memcpy(columns, group_columns, length * sizeof *columns);
     }
 
     template<typename Aggregate>
@@ -20,16 +31,20 @@ namespace ovc::iterators {
 
         for (Row *row; (row = input->next()); input->free()) {
             agg.init(*row);
-            row->setHash(group_columns);
+            row->setHash(columns, group_columns);
             partitioner.put(row);
         }
+        input->close();
+        start(partitioner);
+    }
+
+    template<typename Aggregate>
+    void HashGroupBy<Aggregate>::start(Partitioner &partitioner) {
         partitioner.finalize();
         partitions = partitioner.getPartitionPaths();
         if (!partitions.empty()) {
             rows = process_partition(partitions.back());
         }
-        input->close();
-
         stats.rows_written += partitioner.getStats().rows_written;
     }
 
@@ -67,7 +82,7 @@ namespace ovc::iterators {
     template<typename Aggregate>
     std::vector<Row> HashGroupBy<Aggregate>::process_partition(const std::string &path) {
 
-        auto eq = comparators::EqPrefix(group_columns, &stats);
+        auto eq = comparators::EqColumnList(columns, group_columns, &stats);
         ExternalRunR part(path, bufferManager, true);
         if (part.definitelyEmpty()) {
             return {};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Iterator.h"
+#include "Join.h"
+#include "lib/io/BufferManager.h"
+#include "lib/io/ExternalRunR.h"
+#include "lib/io/ExternalRunW.h"
+#include "lib/comparators.h"
+#include "lib/BloomFilter.h"
+#include "lib/RowHashTable.h"
+#include "lib/Partitioner.h"
+
+#include <memory>
+
+// Number of rows of the right input that are kept in memory before partitions are spilled
+#define HASH_JOIN_MEMORY_ROWS (1 << 16)
+
+#define HASH_JOIN_PARTITIONS (1 << RUN_IDX_BITS)
+
+// Spilled partitions are recursively repartitioned on the next 8 bits of the hash, until all 64 bits are used up
+#define HASH_JOIN_MAX_DEPTH 7
+
+namespace ovc::iterators {
+
+    /**
+     * Hybrid hash join. The right input is the build side: it is kept in an in-memory hash table as long as it fits
+     * into `memory_rows` rows; otherwise the largest partitions are spilled until it does. Left rows that fall into
+     * a resident partition are probed immediately, only left rows of spilled partitions that pass the bloom filter
+     * over the spilled right rows are written to a Partitioner. The filter is sized for the number of spilled right
+     * rows once the right input is exhausted. Spilled partition pairs are joined after the left input is exhausted,
+     * pairs whose right side does not fit into memory are first repartitioned with a Partitioner on the next bits of
+     * the hash (grace hash join).
+     *
+     * Inner and left outer joins produce rows with the layout given by `Project`, semi and anti joins output left rows.
+     */
+    template<JoinType TYPE, typename Project = Concat>
+    class HashJoinBase : public BinaryIterator {
+        static_assert(TYPE != FULL_OUTER_JOIN, "full outer hash joins are not supported");
+    public:
+        HashJoinBase(Iterator *left, Iterator *right, unsigned join_columns, const Project &project,
+                     size_t memory_rows = HASH_JOIN_MEMORY_ROWS);
+
+        void open() override;
+
+        Row *next() override;
+
+        void close() override;
+
+        unsigned long getCount() const {
+            return count;
+        }
+
+        /**
+         * Number of left rows of spilled partitions dropped by the bloom filter.
+         */
+        unsigned long getFiltered() const {
+            return filtered;
+        }
+
+        /**
+         * Number of partitions of the right input that did not fit into memory.
+         */
+        unsigned long getSpilledPartitions() const {
+            return spilled_partitions;
+        }
+
+    private:
+        struct PartitionPair {
+            std::string left;
+            std::string right;
+            size_t right_rows;
+            int depth;
+        };
+
+        comparators::EqPrefix eq;
+        Project project;
+        unsigned join_columns;
+        size_t memory_rows;
+        RowHashTable table;
+        std::vector<std::vector<Row>> resident;
+        std::vector<size_t> spilled_rows; // right rows per partition that was spilled, 0 for resident partitions
+        std::unique_ptr<Partitioner> left_spills; // created at the first spill
+        std::unique_ptr<Partitioner> right_spills;
+        std::vector<PartitionPair> pairs;
+        io::ExternalRunR *left_partition;
+        io::BufferManager bufferManager;
+        BloomFilter bloom;
+        Row out;
+        Row *row_left;
+        const Row *match;
+        bool probed;
+        bool from_input;
+        bool probing_input;
+        unsigned long count;
+        unsigned long filtered;
+        unsigned long spilled_partitions;
+
+        void build();
+
+        void spill(size_t &resident_rows, std::vector<uint64_t> &hashes);
+
+        bool nextLeft();
+
+        void releaseLeft();
+
+        void finishProbe();
+
+        void loadPair();
+
+        void repartition(const PartitionPair &pair, io::ExternalRunR &left_run);
+    };
+
+    class InnerHashJoin : public HashJoinBase<INNER_JOIN> {
+    public:
+        InnerHashJoin(Iterator *left, Iterator *right, unsigned join_columns,
+                      unsigned left_columns = ROW_ARITY / 2, unsigned right_columns = ROW_ARITY / 2,
+                      size_t memory_rows = HASH_JOIN_MEMORY_ROWS)
+                : HashJoinBase<INNER_JOIN>(left, right, join_columns,
+                                           Concat(join_columns, left_columns, right_columns), memory_rows) {}
+    };
+
+    class LeftOuterHashJoin : public HashJoinBase<LEFT_OUTER_JOIN> {
+    public:
+        LeftOuterHashJoin(Iterator *left, Iterator *right, unsigned join_columns,
+                          unsigned left_columns = ROW_ARITY / 2, unsigned right_columns = ROW_ARITY / 2,
+                          size_t memory_rows = HASH_JOIN_MEMORY_ROWS)
+                : HashJoinBase<LEFT_OUTER_JOIN>(left, right, join_columns,
+                                                Concat(join_columns, left_columns, right_columns), memory_rows) {}
+    };
+
+    class LeftAntiHashJoin : public HashJoinBase<LEFT_ANTI_JOIN> {
+    public:
+        LeftAntiHashJoin(Iterator *left, Iterator *right, unsigned join_columns,
+                         size_t memory_rows = HASH_JOIN_MEMORY_ROWS)
+                : HashJoinBase<LEFT_ANTI_JOIN>(left, right, join_columns,
+                                               Concat(join_columns, join_columns, join_columns), memory_rows) {}
+    };
+}
+
+#include "HashJoin.ipp"
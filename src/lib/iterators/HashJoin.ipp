@@ -0,0 +1,317 @@
+#include <algorithm>
+#include "HashJoin.h"
+#include "lib/utils.h"
+
+namespace ovc::iterators {
+    using namespace ovc::io;
+
+    template<JoinType TYPE, typename Project>
+    HashJoinBase<TYPE, Project>::HashJoinBase(Iterator *left, Iterator *right, unsigned join_columns,
+                                              const Project &project, size_t memory_rows)
+            : BinaryIterator(left, right), eq(join_columns, &stats), project(project), join_columns(join_columns),
+              memory_rows(memory_rows), left_partition(nullptr), bufferManager(8), out(), row_left(nullptr),
+              match(nullptr), probed(false), from_input(false), probing_input(false), count(0), filtered(0),
+              spilled_partitions(0) {
+        resident.resize(HASH_JOIN_PARTITIONS);
+        spilled_rows.resize(HASH_JOIN_PARTITIONS, 0);
+    }
+
+    template<JoinType TYPE, typename Project>
+    void HashJoinBase<TYPE, Project>::open() {
+        Iterator::open();
+        build();
+        left->open();
+        probing_input = true;
+    }
+
+    template<JoinType TYPE, typename Project>
+    void HashJoinBase<TYPE, Project>::build() {
+        // hashes of spilled right rows, the bloom filter over them is sized after the right input is exhausted
+        std::vector<uint64_t> hashes;
+        size_t resident_rows = 0;
+
+        right->open();
+        for (Row *row; (row = right->next()); right->free()) {
+            row->setHash(join_columns);
+            stats.columns_hashed += join_columns;
+            auto part = row->key % HASH_JOIN_PARTITIONS;
+            if (spilled_rows[part]) {
+                hashes.push_back(row->key);
+                right_spills->put(row);
+                spilled_rows[part]++;
+            } else {
+                resident[part].push_back(*row);
+                if (++resident_rows > memory_rows) {
+                    spill(resident_rows, hashes);
+                }
+            }
+        }
+        right->close();
+
+        for (auto &part: resident) {
+            for (auto &row: part) {
+                table.insert(row);
+            }
+            std::vector<Row>().swap(part);
+        }
+        table.build();
+
+        if (spilled_partitions > 0) {
+            bloom.resize(hashes.size());
+            for (uint64_t hash: hashes) {
+                bloom.insert(hash);
+            }
+            right_spills->finalize(true);
+            stats.rows_written += right_spills->getStats().rows_written;
+        }
+    }
+
+    template<JoinType TYPE, typename Project>
+    void HashJoinBase<TYPE, Project>::spill(size_t &resident_rows, std::vector<uint64_t> &hashes) {
+        if (spilled_partitions == 0) {
+            left_spills = std::make_unique<Partitioner>(HASH_JOIN_PARTITIONS);
+            right_spills = std::make_unique<Partitioner>(HASH_JOIN_PARTITIONS);
+        }
+        while (resident_rows > memory_rows) {
+            int victim = -1;
+            for (int part = 0; part < HASH_JOIN_PARTITIONS; part++) {
+                if (!spilled_rows[part] && (victim < 0 || resident[part].size() > resident[victim].size())) {
+                    victim = part;
+                }
+            }
+            assert(victim >= 0 && !resident[victim].empty());
+
+            for (auto &row: resident[victim]) {
+                hashes.push_back(row.key);
+                right_spills->put(&row);
+            }
+            spilled_rows[victim] = resident[victim].size();
+            resident_rows -= resident[victim].size();
+            std::vector<Row>().swap(resident[victim]);
+            spilled_partitions++;
+        }
+    }
+
+    template<JoinType TYPE, typename Project>
+    Row *HashJoinBase<TYPE, Project>::next() {
+        Iterator::next();
+
+        for (;;) {
+            if (row_left == nullptr && !nextLeft()) {
+                return nullptr;
+            }
+
+            if constexpr (TYPE == INNER_JOIN || TYPE == LEFT_OUTER_JOIN) {
+                bool first = !probed;
+                match = table.find(*row_left, eq, match);
+                probed = true;
+                if (match) {
+                    project(out, row_left, match);
+                    count++;
+                    return &out;
+                }
+                if (TYPE == LEFT_OUTER_JOIN && first) {
+                    project(out, row_left, nullptr);
+                    releaseLeft();
+                    count++;
+                    return &out;
+                }
+                releaseLeft();
+            } else {
+                bool found = table.find(*row_left, eq) != nullptr;
+                if (found == (TYPE == LEFT_SEMI_JOIN)) {
+                    out = *row_left;
+                    releaseLeft();
+                    count++;
+                    return &out;
+                }
+                releaseLeft();
+            }
+        }
+    }
+
+    template<JoinType TYPE, typename Project>
+    bool HashJoinBase<TYPE, Project>::nextLeft() {
+        probed = false;
+        match = nullptr;
+
+        if (probing_input) {
+            for (Row *row; (row = left->next()); left->free()) {
+                row->setHash(join_columns);
+                stats.columns_hashed += join_columns;
+                auto part = row->key % HASH_JOIN_PARTITIONS;
+                if (!spilled_rows[part]) {
+                    row_left = row;
+                    from_input = true;
+                    return true;
+                }
+                if (bloom.contains(row->key)) {
+                    left_spills->put(row);
+                } else {
+                    // definitely no join partner, the row is never written to a partition
+                    filtered++;
+                    if constexpr (TYPE == LEFT_OUTER_JOIN || TYPE == LEFT_ANTI_JOIN) {
+                        // the table holds no rows of this partition, probing it yields no match
+                        row_left = row;
+                        from_input = true;
+                        return true;
+                    }
+                }
+            }
+            finishProbe();
+        }
+
+        for (;;) {
+            if (left_partition) {
+                Row *row = left_partition->read();
+                if (row) {
+                    stats.rows_read++;
+                    row_left = row;
+                    from_input = false;
+                    return true;
+                }
+                left_partition->remove();
+                delete left_partition;
+                left_partition = nullptr;
+            }
+            if (pairs.empty()) {
+                return false;
+            }
+            loadPair();
+        }
+    }
+
+    template<JoinType TYPE, typename Project>
+    void HashJoinBase<TYPE, Project>::releaseLeft() {
+        if (from_input) {
+            left->free();
+        }
+        row_left = nullptr;
+    }
+
+    template<JoinType TYPE, typename Project>
+    void HashJoinBase<TYPE, Project>::finishProbe() {
+        probing_input = false;
+        left->close();
+        table.clear();
+
+        if (!left_spills) {
+            return;
+        }
+
+        left_spills->finalize(true);
+        stats.rows_written += left_spills->getStats().rows_written;
+
+        // both partitioners keep the paths of empty partitions, so that they are indexed by partition
+        auto left_paths = left_spills->getPartitionPaths();
+        auto right_paths = right_spills->getPartitionPaths();
+        assert(left_paths.size() == HASH_JOIN_PARTITIONS && right_paths.size() == HASH_JOIN_PARTITIONS);
+        for (int part = 0; part < HASH_JOIN_PARTITIONS; part++) {
+            if (spilled_rows[part]) {
+                // pairs without left rows are dropped in loadPair
+                pairs.push_back({left_paths[part], right_paths[part], spilled_rows[part], 1});
+                spilled_rows[part] = 0;
+            }
+        }
+        left_spills.reset();
+        right_spills.reset();
+    }
+
+    template<JoinType TYPE, typename Project>
+    void HashJoinBase<TYPE, Project>::loadPair() {
+        PartitionPair pair = pairs.back();
+        pairs.pop_back();
+        table.clear();
+
+        auto *left_run = new ExternalRunR(pair.left, bufferManager, true);
+        if (left_run->definitelyEmpty()) {
+            left_run->remove();
+            delete left_run;
+            ExternalRunR(pair.right, bufferManager, true).remove();
+            return;
+        }
+
+        if (pair.right_rows > memory_rows && pair.depth < HASH_JOIN_MAX_DEPTH) {
+            repartition(pair, *left_run);
+            delete left_run;
+            return;
+        }
+
+        ExternalRunR right_run(pair.right, bufferManager, true);
+        for (Row *row; (row = right_run.read());) {
+            stats.rows_read++;
+            table.insert(*row);
+        }
+        right_run.remove();
+        table.build();
+
+        left_partition = left_run;
+    }
+
+    template<JoinType TYPE, typename Project>
+    void HashJoinBase<TYPE, Project>::repartition(const PartitionPair &pair, ExternalRunR &left_run) {
+        // enough partitions so that each of them fits into memory, if the hash values are uniform
+        size_t num_partitions = 2 * pair.right_rows / std::max<size_t>(memory_rows, 1) + 1;
+        if (num_partitions > HASH_JOIN_PARTITIONS) {
+            num_partitions = HASH_JOIN_PARTITIONS;
+        }
+
+        std::vector<size_t> right_rows(num_partitions);
+        std::vector<std::string> right_paths;
+        std::vector<std::string> left_paths;
+
+        {
+            Partitioner partitioner(num_partitions);
+            ExternalRunR right_run(pair.right, bufferManager, true);
+            for (Row *row; (row = right_run.read());) {
+                stats.rows_read++;
+                right_rows[row->key % num_partitions]++;
+                partitioner.put(row);
+            }
+            right_run.remove();
+            partitioner.finalize(true);
+            right_paths = partitioner.getPartitionPaths();
+            stats.rows_written += partitioner.getStats().rows_written;
+        }
+
+        {
+            Partitioner partitioner(num_partitions);
+            for (Row *row; (row = left_run.read());) {
+                stats.rows_read++;
+                partitioner.put(row);
+            }
+            left_run.remove();
+            partitioner.finalize(true);
+            left_paths = partitioner.getPartitionPaths();
+            stats.rows_written += partitioner.getStats().rows_written;
+        }
+
+        assert(left_paths.size() == num_partitions && right_paths.size() == num_partitions);
+        for (size_t i = 0; i < num_partitions; i++) {
+            // if nothing was split off, the rows most likely share a single key, repartitioning will not help
+            int depth = right_rows[i] == pair.right_rows ? HASH_JOIN_MAX_DEPTH : pair.depth + 1;
+            pairs.push_back({left_paths[i], right_paths[i], right_rows[i], depth});
+        }
+    }
+
+    template<JoinType TYPE, typename Project>
+    void HashJoinBase<TYPE, Project>::close() {
+        Iterator::close();
+        if (row_left) {
+            releaseLeft();
+        }
+        if (probing_input) {
+            finishProbe();
+        }
+        if (left_partition) {
+            left_partition->remove();
+            delete left_partition;
+            left_partition = nullptr;
+        }
+        for (auto &pair: pairs) {
+            ExternalRunR(pair.left, bufferManager, true).remove();
+            ExternalRunR(pair.right, bufferManager, true).remove();
+        }
+        pairs.clear();
+    }
+}
@@ -7,11 +7,17 @@
 
 namespace ovc::iterators {
 
+    /**
+     * Grouping and aggregation inside the Sorter. With `aggregateInQueue`, input rows whose group still has a row
+     * in the priority queue are merged into that row and never enter the queue, so fewer rows reach the runs.
+     */
     template<typename Aggregate, typename Compare>
     class InSortGroupByBase : public UnaryIterator {
     public:
-        explicit InSortGroupByBase(Iterator *input, int groupColumns, const Aggregate &agg, const Compare &cmp)
+        explicit InSortGroupByBase(Iterator *input, int groupColumns, const Aggregate &agg, const Compare &cmp,
+                                   bool aggregateInQueue = false)
                 : UnaryIterator(input), sorter(&stats, cmp, agg), count(0) {
+            sorter.aggregate_in_queue = aggregateInQueue;
         }
 
         void open() {
@@ -22,7 +28,7 @@ namespace ovc::iterators {
         }
 
         Row *next() {
-            if (sorter.queue.isEmpty()) {
+            if (sorter.cascade.isEmpty()) {
                 return nullptr;
             }
             count++;
@@ -38,6 +44,29 @@ namespace ovc::iterators {
             return count;
         }
 
+        /**
+         * Keep the partial aggregates of up to `capacity` keys that occur in many memory runs in memory across
+         * cycles, instead of writing them to every run. Must be called before open().
+         */
+        InSortGroupByBase *trackHeavyHitters(size_t capacity = QUEUE_CAPACITY) {
+            sorter.heavy_hitter_capacity = capacity;
+            return this;
+        }
+
+        /**
+         * Number of input rows that were aggregated into a heavy hitter.
+         */
+        unsigned long getHeavyHitterHits() const {
+            return sorter.heavy_hitter_hits;
+        }
+
+        /**
+         * Number of input rows that were merged into a row in the priority queue.
+         */
+        unsigned long getQueueMerges() const {
+            return sorter.queue_merges;
+        }
+
     private:
         Sorter<false, Compare, Aggregate> sorter;
         unsigned long count;
@@ -46,16 +75,45 @@ namespace ovc::iterators {
     template<typename Aggregate>
     class InSortGroupByOVC : public InSortGroupByBase<Aggregate, CmpPrefixOVC> {
     public:
-        InSortGroupByOVC(Iterator *input, int groupColumns, const Aggregate &agg = Aggregate())
+        InSortGroupByOVC(Iterator *input, int groupColumns, const Aggregate &agg = Aggregate(),
+                         bool aggregateInQueue = false)
                 : InSortGroupByBase<Aggregate, CmpPrefixOVC>(input, groupColumns, agg,
-                                                             CmpPrefixOVC(groupColumns, &this->stats)) {};
+                                                             CmpPrefixOVC(groupColumns, &this->stats),
+                                                             aggregateInQueue) {};
     };
 
     template<typename Aggregate>
     class InSortGroupBy : public InSortGroupByBase<Aggregate, CmpPrefix> {
     public:
-        InSortGroupBy(Iterator *input, int groupColumns, const Aggregate &agg = Aggregate())
+        InSortGroupBy(Iterator *input, int groupColumns, const Aggregate &agg = Aggregate(),
+                      bool aggregateInQueue = false)
                 : InSortGroupByBase<Aggregate, CmpPrefix>(input, groupColumns, agg,
-                                                          CmpPrefix(groupColumns, &this->stats)) {};
+                                                          CmpPrefix(groupColumns, &this->stats),
+                                                          aggregateInQueue) {};
+    };
+
+    /**
+     * Group on a list of columns, use an aggregate that does not overwrite the group columns, e.g.
+     * aggregates::AggregatesAt.
+     */
+    template<typename Aggregate>
+    class InSortGroupByColumnListOVC : public InSortGroupByBase<Aggregate, CmpColumnListOVC> {
+    public:
+        InSortGroupByColumnListOVC(Iterator *input, const uint8_t *groupColumns, int length,
+                                   const Aggregate &agg = Aggregate(), bool aggregateInQueue = false)
+                : InSortGroupByBase<Aggregate, CmpColumnListOVC>(input, length, agg,
+                                                                 CmpColumnListOVC(groupColumns, length,
+                                                                                  &this->stats),
+                                                                 aggregateInQueue) {};
+    };
+
+    template<typename Aggregate>
+    class InSortGroupByColumnList : public InSortGroupByBase<Aggregate, CmpColumnList> {
+    public:
+        InSortGroupByColumnList(Iterator *input, const uint8_t *groupColumns, int length,
+                                const Aggregate &agg = Aggregate(), bool aggregateInQueue = false)
+                : InSortGroupByBase<Aggregate, CmpColumnList>(input, length, agg,
+                                                              CmpColumnList(groupColumns, length, &this->stats),
+                                                              aggregateInQueue) {};
     };
-}
\ No newline at end of file
+}
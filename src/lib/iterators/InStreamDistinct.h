@@ -20,12 +20,13 @@ namespace ovc::iterators {
         Row *next() override {
             for (Row *row; (row = input->next()); input->free()) {
                 if constexpr (eq.USES_OVC) {
-                    // TODO: we can repair OVCs here
-                    if (row->key != 0) {
+                    // dropped rows are equal to the previous output row on the distinct prefix, so the OVC of the
+                    // next output row w.r.t. its predecessor is also correct w.r.t. the previous output row
+                    if (row->getOffset() < eq.length) {
                         return row;
                     }
                 } else {
-                    if (!has_prev || !row->equals(prev)) {
+                    if (!has_prev || !eq(*row, prev)) {
                         prev = *row;
                         has_prev = true;
                         return row;
@@ -65,4 +66,19 @@ namespace ovc::iterators {
         explicit InStreamDistinct(Iterator *input)
                 : InStreamDistinctBase<Eq>(input, Eq(&this->stats)) {};
     };
+
+    /**
+     * Distinct on the first `prefix` columns, the output rows carry OVCs w.r.t. the prefix.
+     */
+    class InStreamDistinctPrefixOVC : public InStreamDistinctBase<EqPrefixOVC> {
+    public:
+        InStreamDistinctPrefixOVC(Iterator *input, int prefix)
+                : InStreamDistinctBase<EqPrefixOVC>(input, EqPrefixOVC(prefix, &this->stats)) {};
+    };
+
+    class InStreamDistinctPrefix : public InStreamDistinctBase<EqPrefix> {
+    public:
+        InStreamDistinctPrefix(Iterator *input, int prefix)
+                : InStreamDistinctBase<EqPrefix>(input, EqPrefix(prefix, &this->stats)) {};
+    };
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <vector>
 #include "Iterator.h"
 #include "lib/comparators.h"
 
@@ -9,9 +11,10 @@ namespace ovc::iterators {
     template<typename Equals, typename Aggregate>
     class InStreamGroupByBase : public UnaryIterator {
     public:
-        explicit InStreamGroupByBase(Iterator *input, int group_columns, const Equals &eq, const Aggregate &agg)
-                : UnaryIterator(input), acc_buf(), output_buf(),
-                  group_columns(group_columns), empty(true), eq(eq), agg(agg), count(0) {
+        explicit InStreamGroupByBase(Iterator *input, int group_columns, const Equals &eq, const Aggregate &agg,
+                                     bool pre_aggregated = false)
+                : UnaryIterator(input), agg(agg), group_columns(group_columns), count(0), eq(eq), acc_buf(),
+                  output_buf(), empty(true), pre_aggregated(pre_aggregated) {
         }
 
         void open() override {
@@ -20,7 +23,9 @@ namespace ovc::iterators {
             Row *row = input->next();
             if (row) {
                 acc_buf = *row;
-                agg.init(acc_buf);
+                if (!pre_aggregated) {
+                    agg.init(acc_buf);
+                }
                 input->free();
                 empty = false;
             }
@@ -29,47 +34,10 @@ namespace ovc::iterators {
         Row *next() override {
             Iterator::next();
 
-            if (empty) {
+            int offset;
+            if (!nextGroup(output_buf, offset)) {
                 return nullptr;
             }
-
-            for (Row *row; (row = input->next()) != nullptr; input->free()) {
-                agg.init(*row);
-                if constexpr (eq.USES_OVC) {
-                    if (row->getOffset() < group_columns) {
-                        output_buf = acc_buf;
-                        agg.finalize(output_buf);
-
-                        acc_buf = *row;
-                        agg.init(acc_buf);
-                        input->free();
-
-                        count++;
-                        return &output_buf;
-                    }
-                } else {
-                    for (int i = 0; i < group_columns; i++) {
-                        stats.column_comparisons++;
-                        if (row->columns[i] != acc_buf.columns[i]) {
-                            output_buf = acc_buf;
-                            agg.finalize(output_buf);
-
-                            acc_buf = *row;
-                            agg.init(acc_buf);
-                            input->free();
-
-                            count++;
-                            return &output_buf;
-                        }
-                    }
-                }
-                agg.merge(acc_buf, *row);
-            };
-
-            // no more input
-            empty = true;
-
-            output_buf = acc_buf;
             agg.finalize(output_buf);
 
             count++;
@@ -85,14 +53,55 @@ namespace ovc::iterators {
             return count;
         }
 
-    private:
+    protected:
         Aggregate agg;
+        int group_columns;
+        unsigned long count;
+
+        /**
+         * Aggregate the rows of the next group into `group`, which is not finalized yet. `offset` is set to the first
+         * grouping column in which the following group differs, or to -1 at the end of the input.
+         * @return false if there are no more groups
+         */
+        bool nextGroup(Row &group, int &offset) {
+            if (empty) {
+                return false;
+            }
+
+            for (Row *row; (row = input->next()) != nullptr; input->free()) {
+                if (!pre_aggregated) {
+                    agg.init(*row);
+                }
+                if constexpr (eq.USES_OVC) {
+                    offset = row->getOffset();
+                } else {
+                    offset = eq.offset(*row, acc_buf);
+                }
+                if (offset < group_columns) {
+                    group = acc_buf;
+
+                    // the row was already initialized above
+                    acc_buf = *row;
+                    input->free();
+                    return true;
+                }
+                agg.merge(acc_buf, *row);
+            };
+
+            // no more input
+            empty = true;
+
+            group = acc_buf;
+            offset = -1;
+            return true;
+        }
+
+    private:
         Equals eq;
         Row acc_buf;   // holds the first row of the group
         Row output_buf;  // holds the Row we return in next
         bool empty;
-        int group_columns;
-        unsigned long count;
+        bool pre_aggregated;
     };
 
     template<typename Aggregate>
@@ -110,4 +119,126 @@ namespace ovc::iterators {
                 : InStreamGroupByBase<EqPrefix, Aggregate>(input, groupColumns,
                                                            EqPrefix(groupColumns, &this->stats), agg) {};
     };
-}
\ No newline at end of file
+
+    /**
+     * Group on a list of columns, the input must be sorted on these columns (with OVCs w.r.t. them). Use an
+     * aggregate that does not overwrite the group columns, e.g. aggregates::AggregatesAt.
+     */
+    template<typename Aggregate>
+    class InStreamGroupByColumnListOVC : public InStreamGroupByBase<EqColumnListOVC, Aggregate> {
+    public:
+        InStreamGroupByColumnListOVC(Iterator *input, uint8_t *groupColumns, int length,
+                                     const Aggregate &agg = Aggregate())
+                : InStreamGroupByBase<EqColumnListOVC, Aggregate>(input, length,
+                                                                  EqColumnListOVC(groupColumns, length,
+                                                                                  &this->stats), agg) {};
+    };
+
+    template<typename Aggregate>
+    class InStreamGroupByColumnList : public InStreamGroupByBase<EqColumnList, Aggregate> {
+    public:
+        InStreamGroupByColumnList(Iterator *input, uint8_t *groupColumns, int length,
+                                  const Aggregate &agg = Aggregate())
+                : InStreamGroupByBase<EqColumnList, Aggregate>(input, length,
+                                                               EqColumnList(groupColumns, length, &this->stats),
+                                                               agg) {};
+    };
+
+    /**
+     * ROLLUP over an input sorted on its first `group_columns` columns: groups on all prefixes of length
+     * `group_columns` down to `min_columns` are computed in one scan, with one accumulator per level. A row that
+     * differs from its predecessor at offset k closes the groups of all levels deeper than k, each closed group is
+     * merged into the accumulator of the next coarser level before it is output.
+     *
+     * Output rows carry the aggregate as for InStreamGroupBy, the grouping columns that are rolled up are zero and
+     * `tid` holds the level, i.e. the number of grouping columns of the row. With `pre_aggregated`, the input rows
+     * are partial aggregates of the finest level (e.g. from InSortGroupByOVC with aggregates::Partial) and are not
+     * initialized again.
+     */
+    template<typename Equals, typename Aggregate>
+    class InStreamRollupBase : public InStreamGroupByBase<Equals, Aggregate> {
+    public:
+        InStreamRollupBase(Iterator *input, int group_columns, const Equals &eq, const Aggregate &agg,
+                           int min_columns, bool pre_aggregated)
+                : InStreamGroupByBase<Equals, Aggregate>(input, group_columns, eq, agg, pre_aggregated),
+                  acc(group_columns + 1), valid(group_columns + 1, false), pending_pos(0), min_columns(min_columns) {
+            assert(0 <= min_columns && min_columns <= group_columns);
+        }
+
+        Row *next() override {
+            Iterator::next();
+
+            if (pending_pos == pending.size()) {
+                pending.clear();
+                pending_pos = 0;
+
+                // the finest level is grouped by the base class, a group that ends at offset k closes all levels > k
+                int offset;
+                while (pending.empty() && this->nextGroup(acc[this->group_columns], offset)) {
+                    valid[this->group_columns] = true;
+                    closeLevels(offset + 1);
+                }
+                if (pending.empty()) {
+                    return nullptr;
+                }
+            }
+
+            this->count++;
+            return &pending[pending_pos++];
+        }
+
+    private:
+        std::vector<Row> acc;  // accumulator of the current group of each level
+        std::vector<bool> valid;
+        std::vector<Row> pending;  // closed groups that were not returned yet
+        size_t pending_pos;
+        int min_columns;
+
+        /**
+         * Output the groups of all levels >= level, finest first, and pass them on to the next coarser level.
+         */
+        void closeLevels(int level) {
+            auto &agg = this->agg;
+            int group_columns = this->group_columns;
+            for (int l = group_columns; l >= std::max(level, min_columns); l--) {
+                if (!valid[l]) {
+                    continue;
+                }
+                if (l > min_columns) {
+                    if (valid[l - 1]) {
+                        agg.merge(acc[l - 1], acc[l]);
+                    } else {
+                        acc[l - 1] = acc[l];
+                        valid[l - 1] = true;
+                    }
+                }
+                pending.push_back(acc[l]);
+                Row &out = pending.back();
+                agg.finalize(out);
+                memset(out.columns + l, 0, (group_columns - l) * sizeof out.columns[0]);
+                out.tid = l;
+                valid[l] = false;
+            }
+        }
+    };
+
+    template<typename Aggregate>
+    class InStreamRollupOVC : public InStreamRollupBase<EqPrefixOVC, Aggregate> {
+    public:
+        InStreamRollupOVC(Iterator *input, int groupColumns, const Aggregate &agg = Aggregate(), int minColumns = 0,
+                          bool preAggregated = false)
+                : InStreamRollupBase<EqPrefixOVC, Aggregate>(input, groupColumns,
+                                                             EqPrefixOVC(groupColumns, &this->stats), agg,
+                                                             minColumns, preAggregated) {};
+    };
+
+    template<typename Aggregate>
+    class InStreamRollup : public InStreamRollupBase<EqPrefix, Aggregate> {
+    public:
+        InStreamRollup(Iterator *input, int groupColumns, const Aggregate &agg = Aggregate(), int minColumns = 0,
+                       bool preAggregated = false)
+                : InStreamRollupBase<EqPrefix, Aggregate>(input, groupColumns,
+                                                          EqPrefix(groupColumns, &this->stats), agg,
+                                                          minColumns, preAggregated) {};
+    };
+}
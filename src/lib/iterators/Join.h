@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstring>
+#include <algorithm>
+#include "lib/Row.h"
+
+namespace ovc::iterators {
+
+    typedef enum JoinType {
+        INNER_JOIN,
+        LEFT_OUTER_JOIN,
+        FULL_OUTER_JOIN,
+        LEFT_SEMI_JOIN,
+        LEFT_ANTI_JOIN,
+    } JoinType;
+
+    /**
+     * Default output layout of joins: the join key, the remaining `left_columns` columns of the left row, followed by
+     * the non-key columns of the right row, truncated to ROW_ARITY. Columns of a missing side (outer joins) are zero.
+     */
+    struct Concat {
+        unsigned join_columns;
+        unsigned left_columns;
+        unsigned right_columns;
+
+        explicit Concat(unsigned join_columns, unsigned left_columns = ROW_ARITY / 2,
+                        unsigned right_columns = ROW_ARITY / 2)
+                : join_columns(join_columns), left_columns(left_columns), right_columns(right_columns) {
+            assert(join_columns <= left_columns && left_columns <= ROW_ARITY);
+            assert(join_columns <= right_columns && right_columns <= ROW_ARITY);
+        }
+
+        void operator()(Row &out, const Row *left, const Row *right) const {
+            assert(left || right);
+            const Row *key = left ? left : right;
+            out.tid = key->tid;
+            memcpy(out.columns, key->columns, join_columns * sizeof out.columns[0]);
+
+            unsigned n = left_columns - join_columns;
+            if (left) {
+                memcpy(out.columns + join_columns, left->columns + join_columns, n * sizeof out.columns[0]);
+            } else {
+                memset(out.columns + join_columns, 0, n * sizeof out.columns[0]);
+            }
+
+            unsigned m = std::min(right_columns - join_columns, ROW_ARITY - left_columns);
+            if (right) {
+                memcpy(out.columns + left_columns, right->columns + join_columns, m * sizeof out.columns[0]);
+            } else {
+                memset(out.columns + left_columns, 0, m * sizeof out.columns[0]);
+            }
+            memset(out.columns + left_columns + m, 0, (ROW_ARITY - left_columns - m) * sizeof out.columns[0]);
+        }
+    };
+}
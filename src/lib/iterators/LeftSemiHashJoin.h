@@ -1,40 +1,14 @@
 #pragma once
 
-#include <unordered_set>
-#include "Iterator.h"
-#include "lib/io/BufferManager.h"
-#include "lib/io/ExternalRunR.h"
-#include "lib/comparators.h"
+#include "HashJoin.h"
 
 namespace ovc::iterators {
-    class LeftSemiHashJoin : public BinaryIterator {
-    public:
-
-        LeftSemiHashJoin(Iterator *left, Iterator *right, int joinColumns);
-
-        void open() override;
-
-        Row *next() override;
-
-        void free() override;
 
-        void close() override;
-
-        unsigned long getCount() {
-            return count;
-        }
-
-    private:
-        comparators::EqPrefix cmp;
-        unsigned join_columns;
-        std::vector<std::vector<Row>> set;
-        std::vector<std::string> left_partitions;
-        std::vector<std::string> right_partitions;
-        io::ExternalRunR *left_partition;
-        io::ExternalRunR *right_partition;
-        io::BufferManager bufferManager;
-        unsigned long count;
-
-        bool nextPart();
+    class LeftSemiHashJoin : public HashJoinBase<LEFT_SEMI_JOIN> {
+    public:
+        LeftSemiHashJoin(Iterator *left, Iterator *right, int joinColumns,
+                         size_t memory_rows = HASH_JOIN_MEMORY_ROWS)
+                : HashJoinBase<LEFT_SEMI_JOIN>(left, right, joinColumns,
+                                               Concat(joinColumns, joinColumns, joinColumns), memory_rows) {}
     };
-}
\ No newline at end of file
+}
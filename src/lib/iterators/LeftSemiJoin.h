@@ -4,6 +4,7 @@
 #include "lib/comparators.h"
 
 namespace ovc::iterators {
+    using namespace ovc::comparators;
 
     template<typename Compare = CmpPrefix>
     class LeftSemiJoinBase : public BinaryIterator {
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "Iterator.h"
+#include "Join.h"
+#include "lib/comparators.h"
+
+namespace ovc::iterators {
+    using namespace ovc::comparators;
+
+    /**
+     * Merge join of two inputs sorted on their first `join_columns` columns. With an OVC comparator, the inputs must
+     * carry offset-value codes w.r.t. the join key (e.g. from SortPrefixOVC) and the output rows carry offset-value
+     * codes w.r.t. the join key of the previous output row. These are derived with the same max-rule as in
+     * LeftSemiJoinBase: every input row that is not output contributes its OVC to the next output row.
+     */
+    template<JoinType TYPE, typename Compare = CmpPrefix, typename Project = Concat>
+    class MergeJoinBase : public BinaryIterator {
+        static_assert(TYPE != LEFT_SEMI_JOIN, "merge semi joins are implemented by LeftSemiJoinBase");
+    public:
+        MergeJoinBase(Iterator *left, Iterator *right, unsigned join_columns, const Project &project)
+                : BinaryIterator(left, right), cmp(Compare(join_columns, &stats)), project(project),
+                  row_left(nullptr), row_right(nullptr), max_ovc(0), group_ovc(0), group_pos(0), in_group(false),
+                  first_row(true), join_columns(join_columns), count(0) {
+        }
+
+        void open() override {
+            Iterator::open();
+            left->open();
+            right->open();
+            row_left = left->next();
+            row_right = right->next();
+        }
+
+        Row *next() override {
+            Iterator::next();
+            for (;;) {
+                if (in_group) {
+                    // emit the cross product of the current left row and the buffered right rows of this key
+                    if (group_pos < right_group.size()) {
+                        project(out, row_left, &right_group[group_pos++]);
+                        OVC ovc = group_ovc;
+                        group_ovc = 0;
+                        return emit(ovc);
+                    }
+                    advanceLeft();
+                    group_pos = 0;
+                    // rows of the group have OVC zero, the OVC of the first row after the group is w.r.t. the key
+                    // of the group, as is the OVC of the right row following the group
+                    if (row_left && cmp(right_group[0], *row_left) == 0) {
+                        continue;
+                    }
+                    in_group = false;
+                    right_group.clear();
+                    continue;
+                }
+
+                if (row_left == nullptr || row_right == nullptr) {
+                    if (row_left && TYPE != INNER_JOIN) {
+                        return emitLeft();
+                    }
+                    if (row_right && TYPE == FULL_OUTER_JOIN) {
+                        project(out, nullptr, row_right);
+                        OVC ovc = row_right->key;
+                        advanceRight();
+                        return emit(ovc);
+                    }
+                    if (row_left) {
+                        left->free();
+                        row_left = nullptr;
+                    }
+                    if (row_right) {
+                        right->free();
+                        row_right = nullptr;
+                    }
+                    return nullptr;
+                }
+
+                // the larger row gets its OVC w.r.t. the smaller row, which is consumed
+                long c = cmp(*row_left, *row_right);
+
+                if (c < 0) {
+                    // left row has no join partner
+                    if constexpr (TYPE != INNER_JOIN) {
+                        return emitLeft();
+                    }
+                    drop(row_left->key);
+                    advanceLeft();
+                } else if (c > 0) {
+                    // right row has no join partner
+                    if constexpr (TYPE == FULL_OUTER_JOIN) {
+                        project(out, nullptr, row_right);
+                        OVC ovc = row_right->key;
+                        advanceRight();
+                        return emit(ovc);
+                    }
+                    drop(row_right->key);
+                    advanceRight();
+                } else if constexpr (TYPE == LEFT_ANTI_JOIN) {
+                    // right row now has OVC zero w.r.t. the left row and stays
+                    drop(row_left->key);
+                    advanceLeft();
+                } else {
+                    // collect all right rows with this key, the first one now has OVC zero w.r.t. the left row
+                    group_ovc = row_left->key;
+                    right_group.push_back(*row_right);
+                    advanceRight();
+                    while (row_right && cmp(right_group[0], *row_right) == 0) {
+                        right_group.push_back(*row_right);
+                        advanceRight();
+                    }
+                    in_group = true;
+                    group_pos = 0;
+                }
+            }
+        }
+
+        void free() override {
+            Iterator::free();
+        }
+
+        void close() override {
+            Iterator::close();
+            right->close();
+            left->close();
+        }
+
+        long getCount() const {
+            return count;
+        }
+
+    private:
+        Compare cmp;
+        Project project;
+        Row out;
+        Row *row_left;
+        Row *row_right;
+        std::vector<Row> right_group;
+        OVC max_ovc;
+        OVC group_ovc;
+        size_t group_pos;
+        bool in_group;
+        bool first_row;
+        unsigned join_columns;
+        long count;
+
+        inline void advanceLeft() {
+            left->free();
+            row_left = left->next();
+        }
+
+        inline void advanceRight() {
+            right->free();
+            row_right = right->next();
+        }
+
+        inline void drop(OVC ovc) {
+            if constexpr (Compare::USES_OVC) {
+                if (ovc > max_ovc) {
+                    max_ovc = ovc;
+                }
+            }
+        }
+
+        /**
+         * Output the left row without join partner, anti joins output it unchanged.
+         */
+        inline Row *emitLeft() {
+            if constexpr (TYPE == LEFT_ANTI_JOIN) {
+                out = *row_left;
+            } else {
+                project(out, row_left, nullptr);
+            }
+            OVC ovc = row_left->key;
+            advanceLeft();
+            return emit(ovc);
+        }
+
+        /**
+         * Set the OVC of the output row via the max-rule, `ovc` is the OVC of the row itself.
+         */
+        inline Row *emit(OVC ovc) {
+            if constexpr (Compare::USES_OVC) {
+                if (first_row) {
+                    // the very first row we output should have its OVC w.r.t. to the non-existent row
+                    out.setOVCInitial(ROW_ARITY, &stats);
+                    first_row = false;
+                } else {
+                    out.key = ovc > max_ovc ? ovc : max_ovc;
+                }
+                max_ovc = 0;
+            }
+            count++;
+            return &out;
+        }
+    };
+
+    class InnerJoin : public MergeJoinBase<INNER_JOIN, CmpPrefix> {
+    public:
+        InnerJoin(Iterator *left, Iterator *right, unsigned join_columns,
+                  unsigned left_columns = ROW_ARITY / 2, unsigned right_columns = ROW_ARITY / 2)
+                : MergeJoinBase<INNER_JOIN, CmpPrefix>(left, right, join_columns,
+                                                       Concat(join_columns, left_columns, right_columns)) {}
+    };
+
+    class InnerJoinOVC : public MergeJoinBase<INNER_JOIN, CmpPrefixOVC> {
+    public:
+        InnerJoinOVC(Iterator *left, Iterator *right, unsigned join_columns,
+                     unsigned left_columns = ROW_ARITY / 2, unsigned right_columns = ROW_ARITY / 2)
+                : MergeJoinBase<INNER_JOIN, CmpPrefixOVC>(left, right, join_columns,
+                                                          Concat(join_columns, left_columns, right_columns)) {}
+    };
+
+    class LeftOuterJoin : public MergeJoinBase<LEFT_OUTER_JOIN, CmpPrefix> {
+    public:
+        LeftOuterJoin(Iterator *left, Iterator *right, unsigned join_columns,
+                      unsigned left_columns = ROW_ARITY / 2, unsigned right_columns = ROW_ARITY / 2)
+                : MergeJoinBase<LEFT_OUTER_JOIN, CmpPrefix>(left, right, join_columns,
+                                                            Concat(join_columns, left_columns, right_columns)) {}
+    };
+
+    class LeftOuterJoinOVC : public MergeJoinBase<LEFT_OUTER_JOIN, CmpPrefixOVC> {
+    public:
+        LeftOuterJoinOVC(Iterator *left, Iterator *right, unsigned join_columns,
+                         unsigned left_columns = ROW_ARITY / 2, unsigned right_columns = ROW_ARITY / 2)
+                : MergeJoinBase<LEFT_OUTER_JOIN, CmpPrefixOVC>(left, right, join_columns,
+                                                               Concat(join_columns, left_columns, right_columns)) {}
+    };
+
+    class FullOuterJoin : public MergeJoinBase<FULL_OUTER_JOIN, CmpPrefix> {
+    public:
+        FullOuterJoin(Iterator *left, Iterator *right, unsigned join_columns,
+                      unsigned left_columns = ROW_ARITY / 2, unsigned right_columns = ROW_ARITY / 2)
+                : MergeJoinBase<FULL_OUTER_JOIN, CmpPrefix>(left, right, join_columns,
+                                                            Concat(join_columns, left_columns, right_columns)) {}
+    };
+
+    class FullOuterJoinOVC : public MergeJoinBase<FULL_OUTER_JOIN, CmpPrefixOVC> {
+    public:
+        FullOuterJoinOVC(Iterator *left, Iterator *right, unsigned join_columns,
+                         unsigned left_columns = ROW_ARITY / 2, unsigned right_columns = ROW_ARITY / 2)
+                : MergeJoinBase<FULL_OUTER_JOIN, CmpPrefixOVC>(left, right, join_columns,
+                                                               Concat(join_columns, left_columns, right_columns)) {}
+    };
+
+    class LeftAntiJoin : public MergeJoinBase<LEFT_ANTI_JOIN, CmpPrefix> {
+    public:
+        LeftAntiJoin(Iterator *left, Iterator *right, unsigned join_columns)
+                : MergeJoinBase<LEFT_ANTI_JOIN, CmpPrefix>(left, right, join_columns,
+                                                           Concat(join_columns, join_columns, join_columns)) {}
+    };
+
+    class LeftAntiJoinOVC : public MergeJoinBase<LEFT_ANTI_JOIN, CmpPrefixOVC> {
+    public:
+        LeftAntiJoinOVC(Iterator *left, Iterator *right, unsigned join_columns)
+                : MergeJoinBase<LEFT_ANTI_JOIN, CmpPrefixOVC>(left, right, join_columns,
+                                                              Concat(join_columns, join_columns, join_columns)) {}
+    };
+}
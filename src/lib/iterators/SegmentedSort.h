@@ -2,16 +2,32 @@
 
 #include "Iterator.h"
 #include "lib/io/BufferManager.h"
+#include "lib/io/ExternalRunR.h"
+#include "lib/io/ExternalRunW.h"
 #include "lib/PriorityQueue.h"
+#include "lib/RangeMax.h"
 #include "lib/utils.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <queue>
+#include <thread>
 #include <tuple>
 
+// segments per thread in a batch, one batch is returned while the next one is sorted in parallel
+#define SEGMENTED_SORT_BATCH 16
+// rows kept in memory, the runs of larger segments are spilled to disk; split between two batches in parallel
+#define SEGMENTED_SORT_MEMORY (1 << 16)
+#define SEGMENTED_SORT_BUFFERS PAGES_MAX
+#define SEGMENTED_SORT_MAX_FAN_IN ((SEGMENTED_SORT_BUFFERS - 2) / 2)
+
 /*
  * CAUTION:
- * This currently is not a valid ONC operator because it doesn't copy rows into its own memory to sort them, but assumes
- * they exist for the whole lifetime of a segment. A RowBuffer iterator can be used before this one to buffer rows.
+ * The unsegmented variants are not valid ONC operators because they don't copy rows into their own memory to sort them,
+ * but assume they exist for the whole lifetime of the input. A RowBuffer iterator can be used before them to buffer rows.
  */
 
 namespace ovc::iterators {
@@ -30,31 +46,45 @@ namespace ovc::iterators {
         std::vector<Row *> ptrs; // pointers to rows in insertion order
         std::vector<std::tuple<Row **, Row **>> runs; // (begin, end) of runs point into the ptrs array
         Row *next_segment; // first row of the next segment once it is detected
-        std::vector<OVC> stored_ovcs; // original ovcs of the first row in each run; reset for each segment
+        RangeMax stored_ovcs; // original ovcs of the first row in each run; reset for each segment
+        size_t num_threads; // number of segments sorted concurrently, segments are sorted one at a time if <= 1
+        size_t memory_budget; // number of rows held in memory, only used when segmenting
 
         SegmentedSorter(iterator_stats *stats, const EqualsA &eqA, const EqualsB &eqB, const Compare &cmp) :
                 queue(CAPACITY, stats, cmp), stats(stats), eqA(eqA), eqB(eqB), cmp(cmp),
-                next_segment(nullptr) {
-            ptrs.reserve(1 << 21);
-
+                next_segment(nullptr), num_threads(1), memory_budget(SEGMENTED_SORT_MEMORY), current(1),
+                segment_idx(0), row_idx(0), batch_input(nullptr), stopping(false), storage_begin(nullptr),
+                storage_capacity(0), storage_size(0), external(false) {
             assert(cmp.USES_OVC == eqA.USES_OVC);
             assert(cmp.USES_OVC == eqB.USES_OVC);
         }
 
-        ~SegmentedSorter() = default;
+        ~SegmentedSorter() {
+            stop_workers();
+            remove_external_runs();
+        }
 
         void prep_next_segment(Iterator *input) {
             log_trace("prep_next_segment");
 
             assert(queue.isEmpty());
+            remove_external_runs();
+            reserve_storage();
             stored_ovcs.clear();
             runs.clear();
             ptrs.clear();
+            storage_size = 0;
             process_next_segment(input);
             assert(queue.isEmpty());
 
+            if (!spilled_runs.empty()) {
+                merge_spilled_runs();
+                return;
+            }
+
             if constexpr (eqA.USES_OVC) {
-                queue.cmp.stored_ovcs = &stored_ovcs[0];
+                stored_ovcs.build();
+                queue.cmp.stored_ovcs = &stored_ovcs;
             }
 
             size_t num_runs = runs.size();
@@ -63,11 +93,10 @@ namespace ovc::iterators {
                 return;
             }
 
-            if (num_runs > CAPACITY) {
-                assert(false); // disabled for now
-            }
+            // spilling keeps the number of runs in memory within the capacity of the queue
+            assert(num_runs <= CAPACITY);
 
-            insert_memory_runs(runs.size());
+            insert_memory_runs(queue, runs);
 
             if constexpr (eqA.USES_OVC) {
                 // Restore OVC for the first row in the segment
@@ -88,7 +117,8 @@ namespace ovc::iterators {
             assert(queue.isEmpty());
 
             if constexpr (eqA.USES_OVC) {
-                queue.cmp.stored_ovcs = &stored_ovcs[0];
+                stored_ovcs.build();
+                queue.cmp.stored_ovcs = &stored_ovcs;
             }
 
             size_t num_runs = runs.size();
@@ -101,7 +131,7 @@ namespace ovc::iterators {
                 assert(false); // disabled for now
             }
 
-            insert_memory_runs(runs.size());
+            insert_memory_runs(queue, runs);
 
             if constexpr (eqA.USES_OVC) {
                 // Restore OVC for the first row in the segment
@@ -110,12 +140,387 @@ namespace ovc::iterators {
             }
         }
 
+        /**
+         * Return the next batch of up to SEGMENTED_SORT_BATCH segments per thread in input order. The segments are
+         * sorted by a pool of worker threads as soon as they are detected. While a batch is returned, the next one is
+         * detected into the other half of the storage, one segment whenever a segment was returned, so that reading,
+         * sorting and returning rows overlap. A batch ends early if half of its storage is in use or if a segment had
+         * to be spilled; such a segment is merged from disk after the others are returned, and the next batch is
+         * only detected after that since both need the queue.
+         */
+        void prep_next_batch(Iterator *input) {
+            log_trace("prep_next_batch");
+
+            reserve_storage();
+            if (threads.empty()) {
+                batch_input = input;
+                start_workers();
+                begin_batch(current ^ 1);
+            }
+
+            Batch &finished = batches[current];
+            if (finished.external) {
+                assert(queue.isEmpty());
+                remove_external_runs();
+                finished.external = false;
+            }
+
+            while (fill_batch()) {}
+            current ^= 1;
+            segment_idx = 0;
+            row_idx = 0;
+            // all rows of the finished batch were returned, its half of the storage can be reused
+            begin_batch(current ^ 1);
+        }
+
+        inline bool isEmpty() {
+            if (num_threads > 1) {
+                Batch &batch = batches[current];
+                return segment_idx == batch.num_segments && (!batch.external || queue.isEmpty());
+            }
+            return queue.isEmpty();
+        }
+
         inline Row *next() {
-            return queue.pop_memory2();
+            if (num_threads > 1) {
+                Batch &batch = batches[current];
+                if (segment_idx == batch.num_segments) {
+                    return queue.pop_external();
+                }
+
+                Segment &segment = *batch.segments[segment_idx];
+                if (row_idx == 0) {
+                    wait_sorted(segment);
+                    stats->add(segment.stats);
+                }
+                Row *row = segment.sorted[row_idx++];
+                if (row_idx == segment.sorted.size()) {
+                    segment_idx++;
+                    row_idx = 0;
+                    fill_batch();
+                }
+                return row;
+            }
+            return external ? queue.pop_external() : queue.pop_memory2();
         }
 
     private:
-        void insert_memory_runs(size_t num_runs) {
+        // a segment detected in the input, sorted by a worker thread
+        struct Segment {
+            std::vector<Row *> ptrs;
+            std::vector<std::tuple<Row **, Row **>> runs;
+            RangeMax stored_ovcs;
+            std::vector<Row *> sorted;
+            iterator_stats stats; // collected by the worker while sorting the segment
+            bool done; // sorted is complete, guarded by the mutex
+        };
+
+        // segments that are detected into one half of the storage, only with num_threads > 1
+        struct Batch {
+            std::vector<std::unique_ptr<Segment>> segments; // workers hold pointers, segments must not move
+            size_t num_segments = 0;
+            bool complete = true; // no more segments are added
+            bool external = false; // ends with a segment that is merged from disk by the queue
+        };
+
+        struct Worker {
+            iterator_stats stats;
+            PriorityQueue<Compare> queue;
+
+            explicit Worker(const Compare &cmp) : stats(), queue(CAPACITY, &stats, cmp.addStats(&stats)) {}
+        };
+
+        Batch batches[2];
+        size_t current; // batch that is returned, the other one is filled
+        size_t segment_idx; // segment and row within the current batch that is returned next
+        size_t row_idx;
+        Iterator *batch_input; // input the next batch is detected from, null once it is exhausted
+
+        // worker pool, lives as long as the sorter
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable segment_added; // wakes up workers
+        std::condition_variable segment_sorted; // wakes up the thread returning rows
+        std::deque<Segment *> pending; // segments waiting for a worker
+        bool stopping;
+
+        std::unique_ptr<Row[]> storage; // copies of the input rows of the current segment(s)
+        Row *storage_begin; // part of the storage the next segment is copied into
+        size_t storage_capacity;
+        size_t storage_size;
+        Row held_row; // copy of the first row of the next segment
+        std::unique_ptr<io::BufferManager> buffer_manager; // created once the first segment is spilled
+        std::queue<std::string> spilled_runs; // runs of the current segment on disk
+        std::vector<io::ExternalRunR> external_runs; // runs that are currently merged
+        bool external; // the current segment is merged from external runs
+
+        void reserve_storage() {
+            if (!storage) {
+                storage = std::unique_ptr<Row[]>(new Row[memory_budget]);
+                storage_begin = storage.get();
+                storage_capacity = memory_budget;
+                // runs point into ptrs, which therefore must never reallocate
+                ptrs.reserve(memory_budget);
+            }
+        }
+
+        void start_workers() {
+            stopping = false;
+            for (size_t i = 0; i < num_threads; i++) {
+                workers.push_back(std::make_unique<Worker>(cmp));
+                threads.emplace_back(&SegmentedSorter::work, this, std::ref(*workers.back()));
+            }
+        }
+
+        void stop_workers() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            segment_added.notify_all();
+            for (auto &thread: threads) {
+                thread.join();
+            }
+            threads.clear();
+        }
+
+        void work(Worker &worker) {
+            while (true) {
+                Segment *segment;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    segment_added.wait(lock, [this]() { return stopping || !pending.empty(); });
+                    if (stopping) {
+                        return;
+                    }
+                    segment = pending.front();
+                    pending.pop_front();
+                }
+
+                sort_segment(worker.queue, *segment);
+                segment->stats = worker.stats;
+                worker.stats = {};
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    segment->done = true;
+                }
+                segment_sorted.notify_all();
+            }
+        }
+
+        void wait_sorted(Segment &segment) {
+            std::unique_lock<std::mutex> lock(mutex);
+            segment_sorted.wait(lock, [&segment]() { return segment.done; });
+        }
+
+        /**
+         * Start to fill a batch, its segments are copied into its own half of the storage.
+         */
+        void begin_batch(size_t idx) {
+            Batch &batch = batches[idx];
+            batch.num_segments = 0;
+            batch.complete = false;
+            batch.external = false;
+            storage_capacity = memory_budget / 2;
+            storage_begin = storage.get() + idx * storage_capacity;
+            storage_size = 0;
+        }
+
+        /**
+         * Detect the next segment of the batch that is filled and hand it to the workers. Returns false once the
+         * batch is complete, or while the current batch still needs the queue for its spilled segment.
+         */
+        bool fill_batch() {
+            Batch &batch = batches[current ^ 1];
+            if (batch.complete || !batch_input || batches[current].external) {
+                return false;
+            }
+            if (batch.num_segments == num_threads * SEGMENTED_SORT_BATCH
+                || (storage_size > 0 && storage_size >= storage_capacity / 2)) {
+                batch.complete = true;
+                return false;
+            }
+
+            stored_ovcs.clear();
+            runs.clear();
+            ptrs.clear();
+            process_next_segment(batch_input);
+            if (!spilled_runs.empty()) {
+                merge_spilled_runs();
+                batch.external = true;
+                batch.complete = true;
+                return false;
+            }
+            if (runs.empty()) {
+                // the input is exhausted and must not be read again
+                batch.complete = true;
+                batch_input = nullptr;
+                return false;
+            }
+
+            if (batch.segments.size() == batch.num_segments) {
+                batch.segments.push_back(std::make_unique<Segment>());
+            }
+            Segment &segment = *batch.segments[batch.num_segments++];
+            // the runs point into ptrs, which is reused for the next segment
+            segment.ptrs.assign(ptrs.begin(), ptrs.end());
+            segment.runs.clear();
+            for (auto &[begin, end]: runs) {
+                segment.runs.emplace_back(segment.ptrs.data() + (begin - ptrs.data()),
+                                          segment.ptrs.data() + (end - ptrs.data()));
+            }
+            segment.stored_ovcs = stored_ovcs;
+            segment.done = false;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending.push_back(&segment);
+            }
+            segment_added.notify_one();
+            return true;
+        }
+
+        /**
+         * Copy a row from the input into the storage of the sorter and release it.
+         */
+        inline Row *store_row(Iterator *input, Row *row) {
+            assert(storage_size < storage_capacity);
+            Row *stored = &storage_begin[storage_size++];
+            *stored = *row;
+            if (row != &held_row) {
+                input->free();
+            }
+            return stored;
+        }
+
+        /**
+         * Merge the runs of the current segment that are held in memory into a single run on disk. Rows keep the index of
+         * their B-run in tid, so that runs on disk can still derive offset-value codes from stored_ovcs.
+         */
+        void spill_runs(size_t segment_begin) {
+            log_trace("spill_runs %lu", runs.size());
+
+            if (!buffer_manager) {
+                buffer_manager = std::make_unique<io::BufferManager>(SEGMENTED_SORT_BUFFERS);
+            }
+            if constexpr (eqA.USES_OVC) {
+                stored_ovcs.build();
+                queue.cmp.stored_ovcs = &stored_ovcs;
+            }
+
+            insert_memory_runs(queue, runs);
+
+            std::string path = generate_path();
+            io::ExternalRunW run(path, *buffer_manager);
+            while (!queue.isEmpty()) {
+                run.add(*queue.pop_memory2());
+#ifdef COLLECT_STATS
+                stats->rows_written++;
+#endif
+            }
+            spilled_runs.push(path);
+
+            runs.clear();
+            ptrs.clear();
+            storage_size = segment_begin;
+        }
+
+        /**
+         * Merge the spilled runs of the current segment, in multiple passes if there are more runs than the fan-in
+         * allows, and prepare the queue to return the rows of the final merge.
+         */
+        void merge_spilled_runs() {
+            log_trace("merge_spilled_runs %lu", spilled_runs.size());
+
+            size_t fan_in = std::min<size_t>(CAPACITY, SEGMENTED_SORT_MAX_FAN_IN);
+
+            if constexpr (eqA.USES_OVC) {
+                stored_ovcs.build();
+                queue.cmp.stored_ovcs = &stored_ovcs;
+            }
+
+            while (spilled_runs.size() > fan_in) {
+                insert_external_runs(fan_in);
+
+                std::string path = generate_path();
+                io::ExternalRunW run(path, *buffer_manager);
+                while (!queue.isEmpty()) {
+                    run.add(*queue.pop_external());
+#ifdef COLLECT_STATS
+                    stats->rows_written++;
+#endif
+                }
+                remove_external_runs();
+                spilled_runs.push(path);
+            }
+
+            insert_external_runs(spilled_runs.size());
+            external = true;
+
+            if constexpr (eqA.USES_OVC) {
+                // Restore OVC for the first row in the segment
+                assert(!stored_ovcs.empty());
+                queue.top()->key = stored_ovcs[0];
+            }
+        }
+
+        void insert_external_runs(size_t fan_in) {
+            log_trace("insert_external_runs %lu", fan_in);
+
+            assert(fan_in > 0);
+            assert(queue.isEmpty());
+
+            uint64_t next_p2 = p2(fan_in);
+            if (next_p2 != queue.getCapacity()) {
+                queue.reset(next_p2);
+            } else {
+                queue.reset();
+            }
+
+            external_runs.clear();
+            external_runs.reserve(fan_in);
+            for (size_t i = 0; i < fan_in; i++) {
+                external_runs.emplace_back(spilled_runs.front(), *buffer_manager);
+                spilled_runs.pop();
+                queue.push_external(external_runs.back());
+            }
+            queue.flush_sentinels();
+            assert(!queue.isEmpty());
+        }
+
+        void remove_external_runs() {
+            for (auto &run: external_runs) {
+                run.remove();
+            }
+            external_runs.clear();
+            external = false;
+        }
+
+        /**
+         * Merge the runs of a segment into its sorted rows. Only touches the segment and the queue.
+         */
+        void sort_segment(PriorityQueue<Compare> &segment_queue, Segment &segment) {
+            if constexpr (eqA.USES_OVC) {
+                segment.stored_ovcs.build();
+                segment_queue.cmp.stored_ovcs = &segment.stored_ovcs;
+            }
+            insert_memory_runs(segment_queue, segment.runs);
+            if constexpr (eqA.USES_OVC) {
+                // Restore OVC for the first row in the segment
+                segment_queue.top()->key = segment.stored_ovcs[0];
+            }
+
+            segment.sorted.clear();
+            segment.sorted.reserve(segment.ptrs.size());
+            while (!segment_queue.isEmpty()) {
+                segment.sorted.push_back(segment_queue.pop_memory2());
+            }
+        }
+
+        void insert_memory_runs(PriorityQueue<Compare> &queue, std::vector<std::tuple<Row **, Row **>> &runs) {
+            size_t num_runs = runs.size();
             log_trace("insert_memory_runs %lu", num_runs);
 
             assert(num_runs > 0);
@@ -135,10 +540,11 @@ namespace ovc::iterators {
             assert(!queue.isEmpty());
         }
 
-        // processes the next segment in the input
+        // processes the next segment in the input, copying its rows into storage and spilling runs if it is full
         void process_next_segment(Iterator *input) {
             assert(queue.isEmpty());
             assert(runs.empty());
+            assert(spilled_runs.empty());
 
             // Read rows from the segment (until next_from_segment returns null
             // Rows with same B go to the same run
@@ -160,6 +566,9 @@ namespace ovc::iterators {
             stats->segments_found++;
 #endif
 
+            size_t segment_begin = storage_size;
+            row = store_row(input, row);
+
             if constexpr (eqA.USES_OVC) {
                 // First row in run, store its offset-value code
                 stored_ovcs.push_back(row->key);
@@ -172,56 +581,77 @@ namespace ovc::iterators {
             row->tid = run_index;
 
             assert(ptrs.empty());
-            Row **run_first = &ptrs[0];
+            Row **run_first = ptrs.data();
             size_t run_length = 0;
 
             ptrs.push_back(row);
             run_length++;
 
             for (Row *prev = row; (row = input->next()); prev = row) {
+                unsigned long offset;
+                bool new_run;
                 if constexpr (eqA.USES_OVC) {
-                    unsigned long ovc = row->key;
-                    unsigned long offset = OVC_GET_OFFSET(ovc, ROW_ARITY);
+                    offset = OVC_GET_OFFSET(row->key, ROW_ARITY);
                     if (offset < eqA.offset) {
                         // Next segment, hold back the row
                         log_trace("segment boundary detected at row %s", row->c_str());
-                        next_segment = row;
+                        held_row = *row;
+                        input->free();
+                        next_segment = &held_row;
                         break;
-                    } else if (offset < eqB.offset) {
-                        // Change in B detected, create a new run
-                        runs.emplace_back(run_first, run_first + run_length);
-                        run_first = &ptrs[ptrs.size()];
-                        run_length = 0;
-                        run_index++;
-#ifdef COLLECT_STATS
-                        stats->runs_generated++;
-#endif
-                        // First row in run, store its offset-value code
-                        stored_ovcs.push_back(ovc);
-
-                        // Set new offset-value code with offset |A| and value C[0]
-                        row->setNewOVC(eqA.arity, eqA.offset, eqA.columns[eqB.offset]);
-                    } else {
-                        // same run, unless the row is a dupe (indicated by a code of 0), decrement the offset-value code by |B|
-                        if (row->key) {
-                            row->setNewOVC(eqA.arity, offset - (eqB.offset - eqA.offset), eqA.columns[offset]);
-                        }
                     }
+                    new_run = offset < eqB.offset;
                 } else {
                     if (!eqA(*row, *prev)) {
                         // Next segment
-                        next_segment = row;
                         log_trace("segment boundary detected at row %s", row->c_str());
+                        held_row = *row;
+                        input->free();
+                        next_segment = &held_row;
                         break;
-                    } else if (!eqB(*row, *prev)) {
-                        // Change in B detected, create a new run
-                        runs.emplace_back(run_first, run_first + run_length);
-                        run_first = &ptrs[ptrs.size()];
-                        run_length = 0;
-                        run_index++;
+                    }
+                    new_run = !eqB(*row, *prev);
+                }
+
+                if (new_run) {
+                    // Change in B detected, create a new run
+                    runs.emplace_back(run_first, run_first + run_length);
+                    run_first = ptrs.data() + ptrs.size();
+                    run_length = 0;
+                    run_index++;
 #ifdef COLLECT_STATS
-                        stats->runs_generated++;
+                    stats->runs_generated++;
 #endif
+                }
+
+                // the current run continues after a spill, it keeps its index
+                bool continued = false;
+                if (storage_size == storage_capacity || (new_run && runs.size() == CAPACITY)) {
+                    if (run_length > 0) {
+                        runs.emplace_back(run_first, run_first + run_length);
+                        continued = true;
+                    }
+                    spill_runs(segment_begin);
+                    run_first = ptrs.data();
+                    run_length = 0;
+                }
+
+                OVC ovc = row->key;
+                row = store_row(input, row);
+
+                if constexpr (eqA.USES_OVC) {
+                    if (new_run) {
+                        // First row in run, store its offset-value code
+                        stored_ovcs.push_back(ovc);
+
+                        // Set new offset-value code with offset |A| and value C[0]
+                        row->setNewOVC(eqA.arity, eqA.offset, eqA.columns[eqB.offset]);
+                    } else if (continued) {
+                        // First row in memory of a continued run, same as a new run
+                        row->setNewOVC(eqA.arity, eqA.offset, eqA.columns[eqB.offset]);
+                    } else if (row->key) {
+                        // same run, unless the row is a dupe (indicated by a code of 0), decrement the offset-value code by |B|
+                        row->setNewOVC(eqA.arity, offset - (eqB.offset - eqA.offset), eqA.columns[offset]);
                     }
                 }
                 row->tid = run_index;
@@ -235,6 +665,11 @@ namespace ovc::iterators {
                 stats->runs_generated++;
 #endif
             }
+
+            if (!spilled_runs.empty()) {
+                // the segment didn't fit into memory, the rest goes to disk as well
+                spill_runs(segment_begin);
+            }
         }
 
         // whole input is one large segment
@@ -260,6 +695,8 @@ namespace ovc::iterators {
             row->tid = run_index;
 
             assert(ptrs.empty());
+            // rows are not copied, runs point into ptrs which must not reallocate
+            ptrs.reserve(1 << 21);
             Row **run_first = &ptrs[0];
             size_t run_length = 0;
 
@@ -328,18 +765,22 @@ namespace ovc::iterators {
 
         Row *next() override {
             Iterator::next();
-            if (sorter.queue.isEmpty()) {
+            if (sorter.isEmpty()) {
                 if (input_empty) {
                     return nullptr;
                 }
 
                 if constexpr (SEGMENT) {
-                    sorter.prep_next_segment(input);
+                    if (sorter.num_threads > 1) {
+                        sorter.prep_next_batch(input);
+                    } else {
+                        sorter.prep_next_segment(input);
+                    }
                 } else {
                     sorter.prep_next_unsegment(input);
                 }
 
-                if (sorter.queue.isEmpty()) {
+                if (sorter.isEmpty()) {
                     input_empty = true;
                     return nullptr;
                 }
@@ -356,6 +797,26 @@ namespace ovc::iterators {
             input->close();
         }
 
+        /**
+         * Sort up to `num_threads` segments concurrently. Must be called before open().
+         */
+        SegmentedSortBase *parallel(size_t num_threads = std::thread::hardware_concurrency()) {
+            static_assert(SEGMENT, "only segments can be sorted in parallel");
+            sorter.num_threads = num_threads;
+            return this;
+        }
+
+        /**
+         * Set the number of rows held in memory. Runs of segments that don't fit are spilled to disk and merged from
+         * there. Must be called before open().
+         */
+        SegmentedSortBase *memoryBudget(size_t rows) {
+            static_assert(SEGMENT, "only segments are buffered by the sorter");
+            assert(rows > 1);
+            sorter.memory_budget = rows;
+            return this;
+        }
+
     private:
         SegmentedSorter<EqualsA, EqualsB, Compare, CAPACITY> sorter;
         bool input_empty;
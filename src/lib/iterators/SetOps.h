@@ -0,0 +1,216 @@
+#pragma once
+
+#include "Iterator.h"
+#include "lib/comparators.h"
+
+namespace ovc::iterators {
+    using namespace ovc::comparators;
+
+    typedef enum SetOpType {
+        UNION,
+        UNION_ALL,
+        INTERSECT,
+        INTERSECT_ALL,
+        EXCEPT,
+        EXCEPT_ALL,
+    } SetOpType;
+
+    /**
+     * Set operations on two inputs sorted on their first `columns` columns, rows are equal if they agree on these
+     * columns. UNION_ALL merges the inputs, all other operations consume one group of equal rows at a time and
+     * output copies of its first row: once for the distinct variants, min(m, n) times for INTERSECT_ALL and m - n
+     * times for EXCEPT_ALL, where m and n are the number of rows of the group in the left and right input.
+     *
+     * With an OVC comparator, the heads of both inputs always have their OVC w.r.t. the last consumed row, so a
+     * head belongs to the current group iff its OVC is zero and no columns need to be compared. Output OVCs are
+     * repaired with the max-rule, as in Filter<true>.
+     */
+    template<SetOpType TYPE, typename Compare = CmpPrefix>
+    class SetOpBase : public BinaryIterator {
+    public:
+        SetOpBase(Iterator *left, Iterator *right, int columns)
+                : BinaryIterator(left, right), cmp(Compare(columns, &stats)), row_left(nullptr), row_right(nullptr),
+                  out(), copies(0), max_ovc(0), first_row(true), count(0) {
+        }
+
+        void open() override {
+            Iterator::open();
+            left->open();
+            right->open();
+            row_left = left->next();
+            row_right = right->next();
+        }
+
+        Row *next() override {
+            Iterator::next();
+
+            if (copies > 0) {
+                // all further copies are duplicates of the previous output row
+                copies--;
+                if constexpr (Compare::USES_OVC) {
+                    out.key = 0;
+                }
+                count++;
+                return &out;
+            }
+
+            if constexpr (TYPE == UNION_ALL) {
+                if (row_left == nullptr && row_right == nullptr) {
+                    return nullptr;
+                }
+                // the larger row gets its OVC w.r.t. the smaller row, which is output
+                if (row_right == nullptr || (row_left != nullptr && cmp(*row_left, *row_right) <= 0)) {
+                    out = *row_left;
+                    advanceLeft();
+                } else {
+                    out = *row_right;
+                    advanceRight();
+                }
+                return emit(out.key);
+            }
+
+            while (row_left != nullptr || row_right != nullptr) {
+                unsigned long m = 0;
+                unsigned long n = 0;
+
+                long c = row_left == nullptr ? 1 : row_right == nullptr ? -1 : cmp(*row_left, *row_right);
+                if (c <= 0) {
+                    out = *row_left;
+                    advanceLeft();
+                    m++;
+                } else {
+                    out = *row_right;
+                    advanceRight();
+                    n++;
+                }
+
+                while (row_left && inGroup(*row_left)) {
+                    advanceLeft();
+                    m++;
+                }
+                while (row_right && inGroup(*row_right)) {
+                    advanceRight();
+                    n++;
+                }
+
+                unsigned long k = numCopies(m, n);
+                if (k > 0) {
+                    copies = k - 1;
+                    return emit(out.key);
+                }
+                drop(out.key);
+            }
+            return nullptr;
+        }
+
+        void free() override {
+            Iterator::free();
+        }
+
+        void close() override {
+            Iterator::close();
+            if (row_left) {
+                left->free();
+                row_left = nullptr;
+            }
+            if (row_right) {
+                right->free();
+                row_right = nullptr;
+            }
+            right->close();
+            left->close();
+        }
+
+        long getCount() const {
+            return count;
+        }
+
+    private:
+        Compare cmp;
+        Row *row_left;
+        Row *row_right;
+        Row out;
+        unsigned long copies;
+        OVC max_ovc;
+        bool first_row;
+        long count;
+
+        inline void advanceLeft() {
+            left->free();
+            row_left = left->next();
+        }
+
+        inline void advanceRight() {
+            right->free();
+            row_right = right->next();
+        }
+
+        /**
+         * Check if the head of an input is equal to the first row of the current group.
+         */
+        inline bool inGroup(Row &row) {
+            if constexpr (Compare::USES_OVC) {
+                return row.key == 0;
+            } else {
+                return cmp(out, row) == 0;
+            }
+        }
+
+        static inline unsigned long numCopies(unsigned long m, unsigned long n) {
+            switch (TYPE) {
+                case UNION:
+                    return 1;
+                case INTERSECT:
+                    return m > 0 && n > 0;
+                case INTERSECT_ALL:
+                    return m < n ? m : n;
+                case EXCEPT:
+                    return m > 0 && n == 0;
+                case EXCEPT_ALL:
+                    return m > n ? m - n : 0;
+                default:
+                    return m + n;
+            }
+        }
+
+        inline void drop(OVC ovc) {
+            if constexpr (Compare::USES_OVC) {
+                if (ovc > max_ovc) {
+                    max_ovc = ovc;
+                }
+            }
+        }
+
+        /**
+         * Set the OVC of the output row via the max-rule, `ovc` is the OVC of the row itself.
+         */
+        inline Row *emit(OVC ovc) {
+            if constexpr (Compare::USES_OVC) {
+                if (first_row) {
+                    // the very first row we output should have its OVC w.r.t. to the non-existent row
+                    out.setOVCInitial(ROW_ARITY, &stats);
+                    first_row = false;
+                } else {
+                    out.key = ovc > max_ovc ? ovc : max_ovc;
+                }
+                max_ovc = 0;
+            }
+            count++;
+            return &out;
+        }
+    };
+
+    template<SetOpType TYPE>
+    class SetOp : public SetOpBase<TYPE, CmpPrefix> {
+    public:
+        SetOp(Iterator *left, Iterator *right, int columns = ROW_ARITY)
+                : SetOpBase<TYPE, CmpPrefix>(left, right, columns) {}
+    };
+
+    template<SetOpType TYPE>
+    class SetOpOVC : public SetOpBase<TYPE, CmpPrefixOVC> {
+    public:
+        SetOpOVC(Iterator *left, Iterator *right, int columns = ROW_ARITY)
+                : SetOpBase<TYPE, CmpPrefixOVC>(left, right, columns) {}
+    };
+}
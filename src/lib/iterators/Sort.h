@@ -2,16 +2,49 @@
 
 #include "lib/defs.h"
 #include "lib/PriorityQueue.h"
+#include "lib/MergeCascade.h"
 #include "lib/Run.h"
 #include "Iterator.h"
 #include "lib/aggregates.h"
 
+#include <algorithm>
+#include <memory>
 #include <vector>
 #include <queue>
+#include <unordered_map>
 
 namespace ovc::iterators {
     using namespace ovc::comparators;
 
+    /**
+     * Returns rows that were read ahead into a buffer before the remaining rows of its input. The input must already be
+     * open and is not closed by this iterator.
+     */
+    class ReadAhead : public Iterator {
+    public:
+        ReadAhead(Iterator *input, Row *begin, Row *end) : input(input), cur(begin), end(end), from_input(false) {}
+
+        Row *next() override {
+            if (cur < end) {
+                return cur++;
+            }
+            from_input = true;
+            return input->next();
+        }
+
+        void free() override {
+            if (from_input) {
+                input->free();
+            }
+        }
+
+    private:
+        Iterator *input;
+        Row *cur;
+        Row *end;
+        bool from_input;
+    };
+
     template<bool DISTINCT, typename Compare, typename Aggregate = aggregates::Null>
     struct Sorter {
         Compare cmp;
@@ -22,10 +55,37 @@ namespace ovc::iterators {
         std::queue<std::string> external_run_paths;
         std::vector<io::ExternalRunR> external_runs;
         io::BufferManager buffer_manager;
+        // buffers of the runs that are merged, sized by merge_runs for its fan-in
+        std::unique_ptr<io::BufferManager> merge_buffer_manager;
         PriorityQueue<Compare> queue;
+        // merges the external runs, possibly more than fit into the queue
+        MergeCascade<Compare> cascade;
         Row prev;
         bool has_prev;
         iterator_stats *stats;
+        size_t input_rows;
+        size_t run_rows;
+        // merge input rows into a row of the same group that is still in the queue, instead of inserting them
+        bool aggregate_in_queue;
+        size_t queue_merges;
+        // maximum number of keys that are kept in memory across cycles, see merge_heavy_hitter
+        size_t heavy_hitter_capacity;
+        size_t heavy_hitter_hits;
+        // generate runs by replacement selection instead of merging fixed-size in-memory runs
+        bool replacement_selection;
+        // generate runs by partitioning the workspace on the leading sort column and sorting each partition
+        bool radix_partitioning;
+        // generate runs by sorting the whole workspace in a queue of packed nodes, which rarely touches the rows
+        bool indirect_sort;
+        // number of external runs generated from the input
+        size_t initial_runs;
+        // check if the input is already ordered before generating runs, only without aggregation
+        bool detect_presorted;
+        // the whole input was ordered and was not sorted
+        bool presorted;
+        // the ordered input fit into the workspace, it is returned from there
+        bool passthrough;
+        size_t passthrough_pos;
 
         explicit Sorter(iterator_stats *stats, const Compare &cmp, const Aggregate &agg = Aggregate());
 
@@ -33,11 +93,143 @@ namespace ovc::iterators {
 
         void consume(Iterator *input);
 
+        /**
+         * Generate one external run from as much input as fits into the workspace.
+         * @return False if the input is exhausted.
+         */
+        bool consume_run(Iterator *input);
+
+        /**
+         * Merge the external runs until the remaining ones can be merged while calling next().
+         */
+        void merge_runs();
+
+        /**
+         * The fraction of the rows consumed so far that were written to external runs, i.e. the reduction
+         * achieved by aggregation or duplicate removal during run generation.
+         */
+        double getRunRatio() const {
+            return input_rows == 0 ? 1.0 : (double) run_rows / (double) input_rows;
+        }
+
         Row *next();
 
+        inline bool isEmpty() {
+            return passthrough ? passthrough_pos == workspace_size : cascade.isEmpty();
+        }
+
         void cleanup();
 
     private:
+        // rows in the queue by the hash of their group columns, only used with aggregate_in_queue
+        std::unordered_map<unsigned long, Row *> queue_groups;
+
+        // keys that spanned many memory runs in an earlier cycle, with the partial aggregate of their later rows
+        std::vector<Row> heavy_hitters;
+        std::vector<bool> heavy_hitter_filled;
+        std::unordered_map<unsigned long, size_t> heavy_hitter_index;
+        // (number of memory runs, row) of the hottest keys of the current cycle
+        std::vector<std::pair<size_t, Row>> heavy_hitter_candidates;
+
+        // spans the whole workspace, only allocated with replacement_selection or radix_partitioning
+        std::unique_ptr<PriorityQueue<Compare>> workspace_queue;
+        // the rows of the workspace ordered by their partition, only used with radix_partitioning
+        std::vector<Row *> radix_rows;
+
+        // spans the whole workspace, only allocated with indirect_sort
+        std::unique_ptr<PriorityQueue<Compare, true>> packed_queue;
+
+        PriorityQueue<Compare> &getWorkspaceQueue();
+
+        /**
+         * Copy as much input as fits into the workspace.
+         * @return False if the input is exhausted.
+         */
+        bool fill_workspace(Iterator *input);
+
+        /**
+         * Aggregate (or, for DISTINCT, drop) a freshly initialized input row whose key is a heavy hitter, so that it
+         * never reaches a run. Returns false if the key is not in the table.
+         */
+        inline bool merge_heavy_hitter(Row *row) {
+            auto it = heavy_hitter_index.find(group_hash(*row));
+            if (it == heavy_hitter_index.end() || cmp.rawCounted(heavy_hitters[it->second], *row) != 0) {
+                return false;
+            }
+            if constexpr (!agg.IS_NULL) {
+                size_t i = it->second;
+                if (heavy_hitter_filled[i]) {
+                    agg.merge(heavy_hitters[i], *row);
+                } else {
+                    heavy_hitters[i] = *row;
+                    heavy_hitter_filled[i] = true;
+                }
+            }
+            heavy_hitter_hits++;
+            return true;
+        }
+
+        /**
+         * Remember a key that was merged from `runs` memory runs while merging the current cycle.
+         */
+        inline void note_heavy_hitter(const Row &row, size_t runs) {
+            size_t free_slots = heavy_hitter_capacity - heavy_hitters.size();
+            if (runs < 2 || free_slots == 0) {
+                return;
+            }
+            auto greater = [](const std::pair<size_t, Row> &a, const std::pair<size_t, Row> &b) {
+                return a.first > b.first;
+            };
+            if (heavy_hitter_candidates.size() < free_slots) {
+                heavy_hitter_candidates.emplace_back(runs, row);
+                std::push_heap(heavy_hitter_candidates.begin(), heavy_hitter_candidates.end(), greater);
+            } else if (heavy_hitter_candidates.front().first < runs) {
+                std::pop_heap(heavy_hitter_candidates.begin(), heavy_hitter_candidates.end(), greater);
+                heavy_hitter_candidates.back() = {runs, row};
+                std::push_heap(heavy_hitter_candidates.begin(), heavy_hitter_candidates.end(), greater);
+            }
+        }
+
+        /**
+         * Move the candidates of the current cycle into the table, their rows were already written to a run.
+         */
+        void admit_heavy_hitters();
+
+        /**
+         * Write the partial aggregates of the heavy hitters into a sorted external run.
+         */
+        void spill_heavy_hitters();
+
+        inline unsigned long group_hash(const Row &row) {
+            stats->columns_hashed += cmp.length;
+            return row.calcHash(cmp.columns, cmp.length);
+        }
+
+        /**
+         * Merge the freshly initialized row into a row of its group that has not left the queue yet. Returns false
+         * and remembers the row if there is none.
+         */
+        inline bool merge_in_queue(Row *row) {
+            auto [it, inserted] = queue_groups.try_emplace(group_hash(*row), row);
+            if (!inserted) {
+                if (cmp.rawCounted(*it->second, *row) == 0) {
+                    agg.merge(*it->second, *row);
+                    queue_merges++;
+                    return true;
+                }
+                // hash collision, the older row can only be merged with at the next level
+                it->second = row;
+            }
+            return false;
+        }
+
+        inline void forget_in_queue(Row *row) {
+            auto it = queue_groups.find(group_hash(*row));
+            if (it != queue_groups.end() && it->second == row) {
+                queue_groups.erase(it);
+            }
+        }
+
         inline bool equals(Row *row1, Row *row2) {
             if constexpr (cmp.USES_OVC) {
                 return row2->key == 0;
@@ -71,6 +263,60 @@ namespace ovc::iterators {
          */
         bool generate_initial_runs(Iterator *input);
 
+        /**
+         * Generate external runs by replacement selection: an input row joins the current run if it does not precede
+         * the row that was last written to it, otherwise it is assigned to the next run. On random input the runs are
+         * about twice as long as the workspace, a (nearly) sorted input results in a single run.
+         * @return False if the input is exhausted.
+         */
+        bool generate_replacement_runs(Iterator *input);
+
+        /**
+         * Generate an external run from as much input as fits into the workspace: the rows are partitioned (MSD radix)
+         * on the high bits of their leading sort column and each partition is sorted by itself with the queue. Rows of
+         * different partitions differ in the leading column, so the first row of each partition gets the initial OVC.
+         * @return False if the input is exhausted.
+         */
+        bool generate_radix_runs(Iterator *input);
+
+        /**
+         * Generate an external run from as much input as fits into the workspace by sorting it in a single queue of
+         * packed nodes. The nodes hold the OVC, a cached key column and the row index, so that most comparisons do
+         * not touch the rows, which are only copied once more when they are written to the run.
+         * @return False if the input is exhausted.
+         */
+        bool generate_indirect_runs(Iterator *input);
+
+        /**
+         * Append a row that left the queue to the run, aggregating or dropping it if it equals the last row.
+         */
+        inline void append_row(Row *row, io::ExternalRunW &run) {
+            if constexpr (!agg.IS_NULL) {
+                if (run.size() > 0 && equals(run.back(), row)) {
+                    agg.merge(*run.back(), *row);
+                    return;
+                }
+            } else if constexpr (DISTINCT) {
+                if (run.size() > 0 && equals(run.back(), row)) {
+                    return;
+                }
+            }
+            run.add(*row);
+            stats->rows_written++;
+        }
+
+        /**
+         * Finalize an external run generated from the input and queue it for merging.
+         */
+        void finish_external_run(std::unique_ptr<io::ExternalRunW> &run);
+
+        /**
+         * Consume the input while it is ordered, computing the OVCs (and, with DISTINCT, dropping duplicates) on the
+         * way. The rows stay in the workspace as long as they fit, afterwards they go to a single external run.
+         * @return The rows that were read ahead and must still be sorted, nullptr if the whole input was ordered.
+         */
+        std::unique_ptr<ReadAhead> consume_presorted(Iterator *input);
+
         /**
          * Merge all in-memory runs that reside in the queue. It is assumed that every item in the queue is an in-memory run.
          */
@@ -95,8 +341,7 @@ namespace ovc::iterators {
     class SortBase : public UnaryIterator {
     public:
         SortBase(Iterator *input, const Compare &cmp)
-                : UnaryIterator(input), sorter(&stats, cmp), count(0), stats_disabled(false) {
-        };
+                : UnaryIterator(input), sorter(&stats, cmp), count(0), stats_disabled(false) {};
 
         SortBase(Iterator *input) : SortBase(input, Compare(&stats)) {};
 
@@ -108,7 +353,7 @@ namespace ovc::iterators {
         }
 
         Row *next() {
-            if (sorter.queue.isEmpty()) {
+            if (sorter.isEmpty()) {
                 return nullptr;
             }
             count++;
@@ -120,11 +365,79 @@ namespace ovc::iterators {
             sorter.cleanup();
         }
 
+        /**
+         * Check whether the input is already ordered and, if so, pass it through instead of sorting it. Ordered input
+         * is never sorted, so replacementSelection(), radixPartitioning() and indirectSort() have no effect on it.
+         * Must be called before open().
+         */
+        SortBase *detectPresorted(bool enable = true) {
+            sorter.detect_presorted = enable;
+            return this;
+        }
+
+        /**
+         * True if the input was found to be ordered and was not sorted.
+         */
+        bool wasPresorted() const {
+            return sorter.presorted;
+        }
+
         SortBase *disableStats(bool disable = true) {
             stats_disabled = disable;
             return this;
         }
 
+        /**
+         * Keep up to `capacity` keys that occur in many memory runs in memory across cycles, further duplicates of
+         * them are dropped before they reach a run. Must be called before open().
+         */
+        SortBase *trackHeavyHitters(size_t capacity = QUEUE_CAPACITY) {
+            static_assert(DISTINCT, "heavy hitters are only tracked for duplicate removal");
+            sorter.heavy_hitter_capacity = capacity;
+            return this;
+        }
+
+        /**
+         * Generate the initial runs by replacement selection, which adds rows to the current run as long as they do
+         * not precede its last row. Must be called before open().
+         */
+        SortBase *replacementSelection(bool enable = true) {
+            sorter.replacement_selection = enable;
+            return this;
+        }
+
+        /**
+         * Generate the initial runs by partitioning the input on the leading sort column before sorting, which saves
+         * comparisons if that column has a large domain. Must be called before open().
+         */
+        SortBase *radixPartitioning(bool enable = true) {
+            sorter.radix_partitioning = enable;
+            return this;
+        }
+
+        /**
+         * Generate the initial runs by sorting the whole workspace in a queue that compares cached key columns
+         * instead of rows where possible. Must be called before open().
+         */
+        SortBase *indirectSort(bool enable = true) {
+            sorter.indirect_sort = enable;
+            return this;
+        }
+
+        /**
+         * Number of external runs that were generated from the input, before merging.
+         */
+        size_t getInitialRuns() const {
+            return sorter.initial_runs;
+        }
+
+        /**
+         * Number of input rows that were dropped because their key was a heavy hitter.
+         */
+        unsigned long getHeavyHitterHits() const {
+            return sorter.heavy_hitter_hits;
+        }
+
         void accumulateStats(iterator_stats &acc) override {
             input->accumulateStats(acc);
             if (!stats_disabled) {
@@ -14,6 +14,12 @@
 
 #define SORT_INITIAL_RUNS ((1 << RUN_IDX_BITS) - 3)
 #define SORTER_WORKSPACE_CAPACITY (QUEUE_CAPACITY * SORT_INITIAL_RUNS)
+#define SORTER_BUFFERS PAGES_MAX
+// every run that is read holds up to two buffers, taken from the merge buffer manager
+#define SORT_RUN_BUFFERS 2
+#define SORT_MAX_FAN_IN (MERGE_CASCADE_LEAF_RUNS * MERGE_CASCADE_MAX_LEAVES)
+#define SORT_RADIX_BITS 8
+#define SORT_RADIX_BUCKETS (1 << SORT_RADIX_BITS)
 
 namespace ovc::iterators {
 
@@ -21,10 +27,26 @@ namespace ovc::iterators {
     Sorter<DISTINCT, Compare, Aggregate>::Sorter(iterator_stats *stats, const Compare &cmp, const Aggregate &agg) :
             cmp(cmp), agg(agg),
             queue(QUEUE_CAPACITY, stats, cmp),
-            buffer_manager(1024),
+            cascade(stats, cmp),
+            buffer_manager(SORTER_BUFFERS),
             workspace(new Row[SORTER_WORKSPACE_CAPACITY]),
             workspace_size(0),
-            stats(stats) {
+            has_prev(false),
+            stats(stats),
+            input_rows(0),
+            run_rows(0),
+            aggregate_in_queue(false),
+            queue_merges(0),
+            heavy_hitter_capacity(0),
+            heavy_hitter_hits(0),
+            replacement_selection(false),
+            radix_partitioning(false),
+            indirect_sort(false),
+            initial_runs(0),
+            detect_presorted(false),
+            presorted(false),
+            passthrough(false),
+            passthrough_pos(0) {
     }
 
     template<bool DISTINCT, typename Compare, typename Aggregate>
@@ -73,10 +95,24 @@ namespace ovc::iterators {
             workspace[workspace_size] = *row;
             input->free();
             row = &workspace[workspace_size++];
+            if constexpr (!agg.IS_NULL || DISTINCT) {
+                if (!heavy_hitters.empty() && merge_heavy_hitter(row)) {
+                    workspace_size--;
+                    rows_processed++;
+                    continue;
+                }
+            }
             if constexpr (cmp.USES_OVC) {
                 row->key = cmp.makeOVC(ROW_ARITY, 0, row);
                 stats->column_comparisons++;
             }
+            if constexpr (!agg.IS_NULL) {
+                if (aggregate_in_queue && merge_in_queue(row)) {
+                    workspace_size--;
+                    rows_processed++;
+                    continue;
+                }
+            }
             queue.push(row, insert_run_index);
             inserted++;
             rows_processed++;
@@ -107,9 +143,23 @@ namespace ovc::iterators {
             workspace[workspace_size] = *row;
             input->free();
             row = &workspace[workspace_size++];
+            if constexpr (!agg.IS_NULL || DISTINCT) {
+                if (!heavy_hitters.empty() && merge_heavy_hitter(row)) {
+                    workspace_size--;
+                    rows_processed++;
+                    continue;
+                }
+            }
             if constexpr (cmp.USES_OVC) {
                 row->key = cmp.makeOVC(ROW_ARITY, 0, row);
             }
+            if constexpr (!agg.IS_NULL) {
+                if (aggregate_in_queue && merge_in_queue(row)) {
+                    workspace_size--;
+                    rows_processed++;
+                    continue;
+                }
+            }
 #ifndef NDEBUG
             {
                 if (run.isEmpty()) {
@@ -127,6 +177,11 @@ namespace ovc::iterators {
 
             rows_processed++;
             Row *row1 = queue.pop_push(row, insert_run_index);
+            if constexpr (!agg.IS_NULL) {
+                if (aggregate_in_queue) {
+                    forget_in_queue(row1);
+                }
+            }
             process_row(row1, run);
 
             inserted++;
@@ -148,6 +203,7 @@ namespace ovc::iterators {
         }
 
         assert(queue.isCorrect());
+        queue_groups.clear();
 
         if (inserted == 0) {
             if (!queue.isEmpty()) {
@@ -226,6 +282,7 @@ namespace ovc::iterators {
         log_trace("generate_initial_runs: %lu memory_runs generated, last one has getSize: %lu", runs_generated,
                   memory_runs.back().size());
         log_trace("%lu rows processed", rows_processed);
+        input_rows += rows_processed;
 
         if (row == nullptr) {
             log_trace("SortBase::generate_initial_runs(): input empty");
@@ -265,12 +322,26 @@ namespace ovc::iterators {
                 prev = *row;
             }
 #endif
+            if constexpr (agg.IS_NULL && !DISTINCT) {
+                // copy rows while the same run stays ahead of all others, they already have the right OVCs
+                Row **span;
+                size_t n = queue.pop_memory_span(span);
+                for (size_t k = 0; k < n; k++) {
+                    run.add(*span[k]);
+                }
+                stats->rows_written += n;
+                assert(queue.isCorrect());
+                continue;
+            }
             Row *row1 = queue.pop_memory();
+            // number of memory runs the key occurs in
+            size_t runs = 1;
             if constexpr (!agg.IS_NULL) {
                 if constexpr (cmp.USES_OVC) {
                     while (!queue.isEmpty() && queue.top_ovc() == 0) {
                         agg.merge(*row1, *queue.top());
                         queue.pop_memory();
+                        runs++;
                     }
                     run.add(*row1);
                     stats->rows_written++;
@@ -281,14 +352,19 @@ namespace ovc::iterators {
                     while (!queue.isEmpty() && equals(row1, queue.top())) {
                         agg.merge(*row1, *queue.top());
                         queue.pop_memory();
+                        runs++;
                     }
                 }
+                if (heavy_hitter_capacity > 0) {
+                    note_heavy_hitter(*row1, runs);
+                }
             } else if constexpr (DISTINCT) {
                 if constexpr (cmp.USES_OVC) {
                     run.add(*row1);
                     stats->rows_written++;
                     while (!queue.isEmpty() && queue.top_ovc() == 0) {
                         queue.pop_memory();
+                        runs++;
                     }
                 } else {
                     run.add(*row1);
@@ -296,47 +372,320 @@ namespace ovc::iterators {
                     row1 = run.back();
                     while (!queue.isEmpty() && equals(row1, queue.top())) {
                         queue.pop_memory();
+                        runs++;
                     }
                 }
-            } else {
-                run.add(*row1);
-                stats->rows_written++;
+                if (heavy_hitter_capacity > 0) {
+                    note_heavy_hitter(*row1, runs);
+                }
             }
             assert(queue.isCorrect());
         }
 
+        run_rows += run.size();
         if (run.size() > 0) {
             log_trace("external run of length %lu created in %s", run.size(), path.c_str());
             external_run_paths.push(path);
+            initial_runs++;
         }
 
         memory_runs.clear();
+        admit_heavy_hitters();
     }
 
     template<bool DISTINCT, typename Compare, typename Aggregate>
-    void Sorter<DISTINCT, Compare, Aggregate>::insert_external_runs(size_t fan_in) {
-        assert(fan_in <= queue.getCapacity());
-        assert(queue.isEmpty());
-        assert(external_run_paths.size() >= fan_in);
+    PriorityQueue<Compare> &Sorter<DISTINCT, Compare, Aggregate>::getWorkspaceQueue() {
+        if (!workspace_queue) {
+            // the queue is only partially filled if the workspace capacity is not a power of two
+            workspace_queue = std::make_unique<PriorityQueue<Compare>>(p2(SORTER_WORKSPACE_CAPACITY), stats, cmp);
+        }
+        return *workspace_queue;
+    }
 
-        uint64_t next_p2 = p2(fan_in);
-        if (next_p2 != queue.getCapacity()) {
-            queue.reset(next_p2);
-        } else {
-            queue.reset();
+    template<bool DISTINCT, typename Compare, typename Aggregate>
+    bool Sorter<DISTINCT, Compare, Aggregate>::generate_replacement_runs(Iterator *input) {
+        log_trace("SortBase::generate_replacement_runs()");
+
+        PriorityQueue<Compare> &rs_queue = getWorkspaceQueue();
+        rs_queue.clear();
+
+        size_t rows_processed = 0;
+        workspace_size = 0;
+
+        Row *row;
+        while (workspace_size < SORTER_WORKSPACE_CAPACITY && (row = input->next())) {
+            Row *slot = &workspace[workspace_size++];
+            *slot = *row;
+            input->free();
+            if constexpr (!agg.IS_NULL) {
+                agg.init(*slot);
+            }
+            if constexpr (cmp.USES_OVC) {
+                slot->key = cmp.makeOVC(ROW_ARITY, 0, slot);
+            }
+            rs_queue.push(slot, INITIAL_RUN_IDX);
+            rows_processed++;
+        }
+        bool has_more_input = workspace_size == SORTER_WORKSPACE_CAPACITY;
+        rs_queue.flush_sentinels();
+
+        if (rs_queue.isEmpty()) {
+            log_trace("SortBase::generate_replacement_runs(): input empty");
+            return false;
+        }
+
+        Index run_index = INITIAL_RUN_IDX;
+        auto run = std::make_unique<io::ExternalRunW>(generate_path(), buffer_manager);
+
+        while (!rs_queue.isEmpty()) {
+            Index out_index = rs_queue.top_run_idx();
+            if (out_index != run_index) {
+                finish_external_run(run);
+                run = std::make_unique<io::ExternalRunW>(generate_path(), buffer_manager);
+                run_index = out_index;
+            }
+
+            // the slot of the row is reused for the next input row once the row is written
+            Row *out = rs_queue.pop();
+            append_row(out, *run);
+
+            // the run index must not reach MERGE_RUN_IDX, the queue is drained and refilled before
+            row = nullptr;
+            if (has_more_input && out_index + 1 < MERGE_RUN_IDX) {
+                row = input->next();
+                has_more_input = row != nullptr;
+            }
+            if (row == nullptr) {
+                rs_queue.flush_sentinel();
+                continue;
+            }
+
+            Index in_index = out_index;
+            if constexpr (cmp.USES_OVC) {
+                // a row of the current run gets its OVC w.r.t. the row that was just written
+                OVC ovc;
+                if (cmp.rawCounted(*row, *out, &ovc) < 0) {
+                    in_index++;
+                    ovc = cmp.makeOVC(ROW_ARITY, 0, row);
+                }
+                *out = *row;
+                out->key = ovc;
+            } else {
+                if (cmp.rawCounted(*row, *out) < 0) {
+                    in_index++;
+                }
+                *out = *row;
+            }
+            input->free();
+            if constexpr (!agg.IS_NULL) {
+                agg.init(*out);
+            }
+            rs_queue.push(out, in_index);
+            rows_processed++;
         }
 
+        finish_external_run(run);
+        workspace_size = 0;
+        input_rows += rows_processed;
+
+        return has_more_input;
+    }
+
+    template<bool DISTINCT, typename Compare, typename Aggregate>
+    bool Sorter<DISTINCT, Compare, Aggregate>::fill_workspace(Iterator *input) {
+        workspace_size = 0;
+        Row *row;
+        while (workspace_size < SORTER_WORKSPACE_CAPACITY && (row = input->next())) {
+            Row *slot = &workspace[workspace_size++];
+            *slot = *row;
+            input->free();
+            if constexpr (!agg.IS_NULL) {
+                agg.init(*slot);
+            }
+        }
+        input_rows += workspace_size;
+        return workspace_size == SORTER_WORKSPACE_CAPACITY;
+    }
+
+    template<bool DISTINCT, typename Compare, typename Aggregate>
+    bool Sorter<DISTINCT, Compare, Aggregate>::generate_indirect_runs(Iterator *input) {
+        log_trace("SortBase::generate_indirect_runs()");
+
+        bool has_more_input = fill_workspace(input);
+        if (workspace_size == 0) {
+            log_trace("SortBase::generate_indirect_runs(): input empty");
+            return false;
+        }
+
+        if (!packed_queue) {
+            packed_queue = std::make_unique<PriorityQueue<Compare, true>>(p2(SORTER_WORKSPACE_CAPACITY), stats, cmp);
+        }
+        PriorityQueue<Compare, true> &indirect_queue = *packed_queue;
+        indirect_queue.reset(p2(std::max<size_t>(workspace_size, 2)));
+
+        for (size_t i = 0; i < workspace_size; i++) {
+            if constexpr (cmp.USES_OVC) {
+                workspace[i].key = cmp.makeOVC(ROW_ARITY, 0, &workspace[i]);
+            }
+            indirect_queue.push(&workspace[i], INITIAL_RUN_IDX);
+        }
+        indirect_queue.flush_sentinels();
+
+        // the rows are gathered from the workspace in their sorted order, popf() restores their OVCs
+        auto run = std::make_unique<io::ExternalRunW>(generate_path(), buffer_manager);
+        while (!indirect_queue.isEmpty()) {
+            append_row(indirect_queue.popf(), *run);
+        }
+
+        finish_external_run(run);
+        workspace_size = 0;
+
+        return has_more_input;
+    }
+
+    template<bool DISTINCT, typename Compare, typename Aggregate>
+    bool Sorter<DISTINCT, Compare, Aggregate>::generate_radix_runs(Iterator *input) {
+        log_trace("SortBase::generate_radix_runs()");
+
+        bool has_more_input = fill_workspace(input);
+        if (workspace_size == 0) {
+            log_trace("SortBase::generate_radix_runs(): input empty");
+            return false;
+        }
+
+        // the range of the leading column decides which of its bits select the partition
+        uint8_t column = cmp.columns[0];
+        unsigned long lo = workspace[0].columns[column];
+        unsigned long hi = lo;
+        for (size_t i = 1; i < workspace_size; i++) {
+            lo = std::min(lo, workspace[i].columns[column]);
+            hi = std::max(hi, workspace[i].columns[column]);
+        }
+        int shift = 0;
+        while (((hi - lo) >> shift) >= SORT_RADIX_BUCKETS) {
+            shift++;
+        }
+
+        size_t offsets[SORT_RADIX_BUCKETS + 1] = {0};
+        for (size_t i = 0; i < workspace_size; i++) {
+            offsets[((workspace[i].columns[column] - lo) >> shift) + 1]++;
+        }
+        for (size_t b = 0; b < SORT_RADIX_BUCKETS; b++) {
+            offsets[b + 1] += offsets[b];
+        }
+        size_t fill[SORT_RADIX_BUCKETS];
+        std::copy(offsets, offsets + SORT_RADIX_BUCKETS, fill);
+        radix_rows.resize(workspace_size);
+        for (size_t i = 0; i < workspace_size; i++) {
+            radix_rows[fill[(workspace[i].columns[column] - lo) >> shift]++] = &workspace[i];
+        }
+
+        PriorityQueue<Compare> &radix_queue = getWorkspaceQueue();
+        auto run = std::make_unique<io::ExternalRunW>(generate_path(), buffer_manager);
+
+        for (size_t b = 0; b < SORT_RADIX_BUCKETS; b++) {
+            size_t begin = offsets[b];
+            size_t end = offsets[b + 1];
+            if (begin == end) {
+                continue;
+            }
+            radix_queue.reset(p2(std::max<size_t>(end - begin, 2)));
+            for (size_t i = begin; i < end; i++) {
+                if constexpr (cmp.USES_OVC) {
+                    radix_rows[i]->key = cmp.makeOVC(ROW_ARITY, 0, radix_rows[i]);
+                }
+                radix_queue.push(radix_rows[i], INITIAL_RUN_IDX);
+            }
+            radix_queue.flush_sentinels();
+            while (!radix_queue.isEmpty()) {
+                append_row(radix_queue.popf(), *run);
+            }
+        }
+
+        finish_external_run(run);
+        workspace_size = 0;
+
+        return has_more_input;
+    }
+
+    template<bool DISTINCT, typename Compare, typename Aggregate>
+    void Sorter<DISTINCT, Compare, Aggregate>::finish_external_run(std::unique_ptr<io::ExternalRunW> &run) {
+        run_rows += run->size();
+        if (run->size() > 0) {
+            log_trace("external run of length %lu created in %s", run->size(), run->path().c_str());
+            external_run_paths.push(run->path());
+            initial_runs++;
+        }
+        run.reset();
+    }
+
+    template<bool DISTINCT, typename Compare, typename Aggregate>
+    void Sorter<DISTINCT, Compare, Aggregate>::admit_heavy_hitters() {
+        for (auto &[runs, row]: heavy_hitter_candidates) {
+            auto [it, inserted] = heavy_hitter_index.try_emplace(group_hash(row), heavy_hitters.size());
+            if (inserted) {
+                heavy_hitters.push_back(row);
+                heavy_hitter_filled.push_back(false);
+            }
+        }
+        heavy_hitter_candidates.clear();
+    }
+
+    template<bool DISTINCT, typename Compare, typename Aggregate>
+    void Sorter<DISTINCT, Compare, Aggregate>::spill_heavy_hitters() {
+        if constexpr (!agg.IS_NULL) {
+            std::vector<Row> partials;
+            for (size_t i = 0; i < heavy_hitters.size(); i++) {
+                if (heavy_hitter_filled[i]) {
+                    partials.push_back(heavy_hitters[i]);
+                }
+            }
+            if (!partials.empty()) {
+                std::sort(partials.begin(), partials.end(), [this](const Row &a, const Row &b) {
+                    return cmp.rawCounted(a, b) < 0;
+                });
+
+                std::string path = generate_path();
+                io::ExternalRunW run(path, buffer_manager);
+                for (size_t i = 0; i < partials.size(); i++) {
+                    Row &row = partials[i];
+                    if constexpr (cmp.USES_OVC) {
+                        // the keys are unique, every row differs from its predecessor within the key
+                        int offset = 0;
+                        if (i > 0) {
+                            while (row.columns[cmp.columns[offset]] == partials[i - 1].columns[cmp.columns[offset]]) {
+                                offset++;
+                            }
+                        }
+                        row.key = cmp.makeOVC(ROW_ARITY, offset, &row);
+                    }
+                    run.add(row);
+                    stats->rows_written++;
+                }
+                log_trace("heavy hitter run of length %lu created in %s", run.size(), path.c_str());
+                external_run_paths.push(path);
+            }
+        }
+        heavy_hitters.clear();
+        heavy_hitter_filled.clear();
+        heavy_hitter_index.clear();
+    }
+
+    template<bool DISTINCT, typename Compare, typename Aggregate>
+    void Sorter<DISTINCT, Compare, Aggregate>::insert_external_runs(size_t fan_in) {
+        assert(fan_in <= SORT_MAX_FAN_IN);
+        assert(external_run_paths.size() >= fan_in);
+
         external_runs.clear();
         external_runs.reserve(external_run_paths.size());
 
         for (size_t i = 0; i < fan_in; i++) {
             assert(!external_run_paths.empty());
             auto &path = external_run_paths.front();
-            external_runs.emplace_back(path, buffer_manager);
+            external_runs.emplace_back(path, *merge_buffer_manager);
             external_run_paths.pop();
-            queue.push_external(external_runs.back());
         }
-        queue.flush_sentinels();
+        cascade.insert(external_runs.data(), external_runs.size());
     }
 
     template<bool DISTINCT, typename Compare, typename Aggregate>
@@ -351,12 +700,12 @@ namespace ovc::iterators {
         prev = {0};
 #endif
 
-        while (!queue.isEmpty()) {
+        while (!cascade.isEmpty()) {
 #ifndef NDEBUG
             {
-                Row *top = queue.top();
+                Row *top = cascade.top();
                 if (cmp.raw(*top, prev) < 0) {
-                    const std::string &run_path = queue.top_path();
+                    const std::string &run_path = cascade.top_path();
                     log_error("SortBase::merge_external(): not ascending in run %s", run_path.c_str());
                     log_error("SortBase::merge_external(): prev %s", prev.c_str());
                     log_error("SortBase::merge_external(): cur  %s", top->c_str());
@@ -365,22 +714,22 @@ namespace ovc::iterators {
                 prev = *top;
             }
 #endif
-            Row *row = queue.pop_external();
+            Row *row = cascade.pop_external();
             stats->rows_read++;
             if constexpr (!agg.IS_NULL) {
                 run.add(*row);;
                 stats->rows_written++;
                 row = run.back();
                 if constexpr (cmp.USES_OVC) {
-                    while (!queue.isEmpty() && queue.top_ovc() == 0) {
-                        agg.merge(*row, *queue.top());
-                        queue.pop_external();
+                    while (!cascade.isEmpty() && cascade.top_ovc() == 0) {
+                        agg.merge(*row, *cascade.top());
+                        cascade.pop_external();
                         stats->rows_read++;
                     }
                 } else {
-                    while (!queue.isEmpty() && equals(row, queue.top())) {
-                        agg.merge(*row, *queue.top());
-                        queue.pop_external();
+                    while (!cascade.isEmpty() && equals(row, cascade.top())) {
+                        agg.merge(*row, *cascade.top());
+                        cascade.pop_external();
                         stats->rows_read++;
                     }
                 }
@@ -388,16 +737,16 @@ namespace ovc::iterators {
                 if constexpr (cmp.USES_OVC) {
                     run.add(*row);;
                     stats->rows_written++;
-                    while (!queue.isEmpty() && queue.top_ovc() == 0) {
-                        queue.pop_external();
+                    while (!cascade.isEmpty() && cascade.top_ovc() == 0) {
+                        cascade.pop_external();
                         stats->rows_read++;
                     }
                 } else {
                     run.add(*row);;
                     stats->rows_written++;
                     row = run.back();
-                    while (!queue.isEmpty() && equals(row, queue.top())) {
-                        queue.pop_external();
+                    while (!cascade.isEmpty() && equals(row, cascade.top())) {
+                        cascade.pop_external();
                         stats->rows_read++;
                     }
                 }
@@ -419,30 +768,153 @@ namespace ovc::iterators {
 
     template<bool DISTINCT, typename Compare, typename Aggregate>
     void Sorter<DISTINCT, Compare, Aggregate>::consume(Iterator *input) {
-        for (bool has_more_input = true; has_more_input;) {
-            has_more_input = generate_initial_runs(input);
-            merge_in_memory();
-            assert(memory_runs.empty());
+        if (agg.IS_NULL && detect_presorted) {
+            std::unique_ptr<ReadAhead> read_ahead = consume_presorted(input);
+            if (read_ahead) {
+                read_ahead->open();
+                while (consume_run(read_ahead.get())) {}
+                read_ahead->close();
+            }
+        } else {
+            while (consume_run(input)) {}
         }
+        if (!passthrough) {
+            merge_runs();
+        }
+    }
+
+    template<bool DISTINCT, typename Compare, typename Aggregate>
+    std::unique_ptr<ReadAhead> Sorter<DISTINCT, Compare, Aggregate>::consume_presorted(Iterator *input) {
+        log_trace("SortBase::consume_presorted()");
+
+        workspace_size = 0;
+        std::unique_ptr<io::ExternalRunW> run;
+
+        auto spill = [&]() {
+            run = std::make_unique<io::ExternalRunW>(generate_path(), buffer_manager);
+            for (size_t i = 0; i < workspace_size; i++) {
+                run->add(workspace[i]);
+            }
+            stats->rows_written += workspace_size;
+            workspace_size = 0;
+        };
+
+        Row *prev = nullptr;
+        Row *row;
+        while ((row = input->next())) {
+            OVC ovc = 0;
+            if (prev != nullptr) {
+                long cmp_;
+                if constexpr (cmp.USES_OVC) {
+                    cmp_ = cmp.rawCounted(*row, *prev, &ovc);
+                } else {
+                    cmp_ = cmp.rawCounted(*row, *prev);
+                }
+                if (cmp_ < 0) {
+                    break;
+                }
+                if constexpr (DISTINCT) {
+                    if (cmp_ == 0) {
+                        input->free();
+                        continue;
+                    }
+                }
+            } else if constexpr (cmp.USES_OVC) {
+                ovc = cmp.makeOVC(ROW_ARITY, 0, row);
+            }
+
+            if (run == nullptr && workspace_size == SORTER_WORKSPACE_CAPACITY) {
+                spill();
+            }
+            if (run == nullptr) {
+                prev = &workspace[workspace_size++];
+                *prev = *row;
+                prev->key = ovc;
+            } else {
+                // the last row of the run stays valid until the next one is added
+                Row tmp = *row;
+                tmp.key = ovc;
+                run->add(tmp);
+                stats->rows_written++;
+                prev = run->back();
+            }
+            input->free();
+        }
+
+        if (row == nullptr) {
+            log_trace("SortBase::consume_presorted(): input is ordered");
+            presorted = true;
+            if (run != nullptr) {
+                finish_external_run(run);
+            } else {
+                passthrough = true;
+                passthrough_pos = 0;
+            }
+            return nullptr;
+        }
+
+        // the ordered prefix is sorted again with the rest of the input, unless it was already spilled as a run
+        if (run == nullptr && workspace_size == SORTER_WORKSPACE_CAPACITY) {
+            spill();
+        }
+        if (run != nullptr) {
+            finish_external_run(run);
+        }
+        workspace[workspace_size++] = *row;
+        input->free();
+        log_trace("SortBase::consume_presorted(): input is not ordered");
+
+        size_t read_ahead = workspace_size;
+        workspace_size = 0;
+        return std::make_unique<ReadAhead>(input, workspace, workspace + read_ahead);
+    }
+
+    template<bool DISTINCT, typename Compare, typename Aggregate>
+    bool Sorter<DISTINCT, Compare, Aggregate>::consume_run(Iterator *input) {
+        if (replacement_selection) {
+            return generate_replacement_runs(input);
+        }
+        if (radix_partitioning) {
+            return generate_radix_runs(input);
+        }
+        if (indirect_sort) {
+            return generate_indirect_runs(input);
+        }
+        bool has_more_input = generate_initial_runs(input);
+        merge_in_memory();
+        assert(memory_runs.empty());
+        return has_more_input;
+    }
+
+    template<bool DISTINCT, typename Compare, typename Aggregate>
+    void Sorter<DISTINCT, Compare, Aggregate>::merge_runs() {
+        spill_heavy_hitters();
 
         size_t num_runs = external_run_paths.size();
-        size_t capacity = queue.getCapacity();
+        // every run that is read keeps its file open, leave half of the descriptors to the rest of the plan. The limit
+        // in effect is used, the main program may raise it with raise_open_files_limit()
+        size_t fan_in = std::min<size_t>(SORT_MAX_FAN_IN, max_open_files() / 2);
+
+        // output runs are written through buffer_manager, the runs that are read get their own buffers
+        assert(external_runs.empty());
+        merge_buffer_manager = std::make_unique<io::BufferManager>(SORT_RUN_BUFFERS * std::min(num_runs, fan_in));
 
-        if (num_runs > capacity) {
+        if (num_runs > fan_in) {
             // this guarantees maximal fan-in for the later merges
-            size_t initial_merge_fan_in = num_runs % (capacity - 1);
+            size_t initial_merge_fan_in = num_runs % (fan_in - 1);
             if (initial_merge_fan_in == 0) {
-                initial_merge_fan_in = capacity - 1;
+                initial_merge_fan_in = fan_in - 1;
             }
             merge_external_runs(initial_merge_fan_in);
         }
 
-        while (external_run_paths.size() > capacity) {
-            merge_external_runs(capacity);
+        while (external_run_paths.size() > fan_in) {
+            merge_external_runs(fan_in);
         }
 
         insert_external_runs(external_run_paths.size());
 
+        has_prev = false;
 #ifndef NDEBUG
         prev = {0};
 #endif
@@ -451,21 +923,44 @@ namespace ovc::iterators {
 
     template<bool DISTINCT, typename Compare, typename Aggregate>
     Row *Sorter<DISTINCT, Compare, Aggregate>::next() {
+        if (passthrough) {
+            return &workspace[passthrough_pos++];
+        }
+
+        if constexpr (!agg.IS_NULL) {
+            Row *row = cascade.pop_external();
+            if constexpr (cmp.USES_OVC) {
+                // the group is returned in its last row, which gets the OVC of the first
+                OVC ovc = row->key;
+                while (!cascade.isEmpty() && cascade.top_ovc() == 0) {
+                    agg.merge(*cascade.top(), *row);
+                    row = cascade.pop_external();
+                }
+                row->key = ovc;
+            } else {
+                while (!cascade.isEmpty() && equals(cascade.top(), row)) {
+                    agg.merge(*cascade.top(), *row);
+                    row = cascade.pop_external();
+                }
+            }
+            agg.finalize(*row);
+            return row;
+        }
 
 #ifndef NDEBUG
         Row *row = nullptr;
         if constexpr (DISTINCT) {
             if constexpr (cmp.USES_OVC) {
-                while ((row = queue.pop_external()) && row->key == 0) {
-                    if (queue.isEmpty()) {
+                while ((row = cascade.pop_external()) && row->key == 0) {
+                    if (cascade.isEmpty()) {
                         row = nullptr;
                         break;
                     }
                 }
             } else {
-                while ((row = queue.pop_external())) {
+                while ((row = cascade.pop_external())) {
                     if (has_prev && (cmp.raw(*row, prev) == 0)) {
-                        if (queue.isEmpty()) {
+                        if (cascade.isEmpty()) {
                             row = nullptr;
                             break;
                         }
@@ -475,7 +970,7 @@ namespace ovc::iterators {
                 }
             }
         } else {
-            return queue.pop_external();
+            return cascade.pop_external();
         }
 
         if (row == nullptr) {
@@ -483,7 +978,7 @@ namespace ovc::iterators {
         }
 
         if (cmp.raw(*row, prev) < 0) {
-            const std::string &run_path = queue.top_path();
+            const std::string &run_path = cascade.top_path();
             log_error("SortBase::merge_external(): not ascending in run %s", run_path.c_str());
             log_error("SortBase::merge_external(): prev %s", prev.c_str());
             log_error("SortBase::merge_external(): cur  %s", row->c_str());
@@ -494,34 +989,19 @@ namespace ovc::iterators {
         prev = *row;
         return row;
 #else
-        if constexpr (!agg.IS_NULL) {
-            Row *row = queue.pop_external();
-            if constexpr (cmp.USES_OVC) {
-                while (!queue.isEmpty() && queue.top_ovc() == 0) {
-                    agg.merge(*queue.top(), *row);
-                    row = queue.pop_external();
-                }
-            } else {
-                while (!queue.isEmpty() && equals(queue.top(), row)) {
-                    agg.merge(*queue.top(), *row);
-                    row = queue.pop_external();
-                }
-            }
-            agg.finalize(*row);
-            return row;
-        } else if constexpr (DISTINCT) {
+        if constexpr (DISTINCT) {
             Row *row = nullptr;
             if constexpr (cmp.USES_OVC) {
-                while ((row = queue.pop_external()) && row->key == 0) {
-                    if (queue.isEmpty()) {
+                while ((row = cascade.pop_external()) && row->key == 0) {
+                    if (cascade.isEmpty()) {
                         row = nullptr;
                         break;
                     }
                 }
             } else {
-                while ((row = queue.pop_external())) {
+                while ((row = cascade.pop_external())) {
                     if (has_prev && row->equals(prev)) {
-                        if (queue.isEmpty()) {
+                        if (cascade.isEmpty()) {
                             row = nullptr;
                             break;
                         }
@@ -534,7 +1014,7 @@ namespace ovc::iterators {
             }
             return row;
         } else {
-            return queue.pop_external();
+            return cascade.pop_external();
         }
 #endif
     }
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Iterator.h"
+#include "lib/PriorityQueue.h"
+#include "lib/comparators.h"
+#include "lib/utils.h"
+
+#include <vector>
+
+namespace ovc::iterators {
+    using namespace ovc::comparators;
+
+    /**
+     * Returns the first k rows of the sorted input, without spilling. Input rows are collected in batches in a
+     * tree-of-losers, each sorted batch is merged with the best k rows seen so far. Once k rows are known, rows that
+     * are not smaller than the k-th row can not qualify and are dropped before they enter the queue.
+     * With an OVC comparator, the output rows carry offset-value codes w.r.t. their predecessor.
+     */
+    template<typename Compare>
+    class TopKBase : public UnaryIterator {
+    public:
+        TopKBase(Iterator *input, size_t k, const Compare &cmp)
+                : UnaryIterator(input), cmp(cmp), k(k), batch_size(p2(std::max<size_t>(k, QUEUE_CAPACITY))),
+                  queue(batch_size, &stats, cmp), batch(new Row[batch_size]), batch_rows(0), pos(0),
+                  dropped(0) {
+        }
+
+        ~TopKBase() override {
+            delete[] batch;
+        }
+
+        void open() override {
+            Iterator::open();
+            input->open();
+            if (k > 0) {
+                for (Row *row; (row = input->next()); input->free()) {
+                    if (best.size() == k && cmp.raw(*row, best.back()) >= 0) {
+                        dropped++;
+                        continue;
+                    }
+                    Row *dst = &batch[batch_rows++];
+                    *dst = *row;
+                    if constexpr (cmp.USES_OVC) {
+                        dst->key = cmp.makeOVC(ROW_ARITY, 0, dst);
+                    }
+                    queue.push(dst, INITIAL_RUN_IDX);
+                    if (batch_rows == batch_size) {
+                        flush();
+                    }
+                }
+                flush();
+            }
+            input->close();
+        }
+
+        Row *next() override {
+            Iterator::next();
+            if (pos >= best.size()) {
+                return nullptr;
+            }
+            return &best[pos++];
+        }
+
+        void close() override {
+            Iterator::close();
+            std::vector<Row>().swap(best);
+        }
+
+        /**
+         * Number of input rows that were dropped without entering the queue.
+         */
+        unsigned long getDropped() const {
+            return dropped;
+        }
+
+    private:
+        Compare cmp;
+        size_t k;
+        size_t batch_size;
+        PriorityQueue<Compare> queue;
+        Row *batch;
+        size_t batch_rows;
+        std::vector<Row> best;
+        std::vector<Row> merged;
+        std::vector<Row *> sorted;
+        size_t pos;
+        unsigned long dropped;
+
+        /**
+         * Sort the current batch and merge its first k rows into the best rows.
+         */
+        void flush() {
+            if (batch_rows == 0) {
+                return;
+            }
+            queue.flush_sentinels();
+            sorted.clear();
+            while (!queue.isEmpty() && sorted.size() < k) {
+                sorted.push_back(queue.popf());
+            }
+            queue.clear();
+            batch_rows = 0;
+
+            // the first rows of both runs have their OVC w.r.t. the same (non-existent) row, afterwards, the heads of
+            // both runs have their OVC w.r.t. the last row that was output
+            merged.clear();
+            size_t i = 0, j = 0;
+            while (merged.size() < k && (i < best.size() || j < sorted.size())) {
+                if (j == sorted.size() || (i < best.size() && cmp(best[i], *sorted[j]) <= 0)) {
+                    merged.push_back(best[i++]);
+                } else {
+                    merged.push_back(*sorted[j++]);
+                }
+            }
+            best.swap(merged);
+        }
+    };
+
+    class TopK : public TopKBase<Cmp> {
+    public:
+        TopK(Iterator *input, size_t k) : TopKBase<Cmp>(input, k, Cmp(&this->stats)) {}
+    };
+
+    class TopKOVC : public TopKBase<CmpOVC> {
+    public:
+        TopKOVC(Iterator *input, size_t k) : TopKBase<CmpOVC>(input, k, CmpOVC(&this->stats)) {}
+    };
+
+    class TopKPrefix : public TopKBase<CmpPrefix> {
+    public:
+        TopKPrefix(Iterator *input, size_t k, int prefix)
+                : TopKBase<CmpPrefix>(input, k, CmpPrefix(prefix, &this->stats)) {}
+    };
+
+    class TopKPrefixOVC : public TopKBase<CmpPrefixOVC> {
+    public:
+        TopKPrefixOVC(Iterator *input, size_t k, int prefix)
+                : TopKBase<CmpPrefixOVC>(input, k, CmpPrefixOVC(prefix, &this->stats)) {}
+    };
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <tuple>
+#include "Iterator.h"
+#include "lib/aggregates.h"
+
+namespace ovc::window {
+
+    /**
+     * Position of a row relative to its predecessor in the sorted input.
+     */
+    typedef enum Boundary {
+        NEW_PARTITION,
+        NEW_PEER_GROUP,
+        PEER,
+    } Boundary;
+
+    /**
+     * Window functions first see every row with `update`, afterwards `write` stores their result in column OUT.
+     */
+    template<int OUT>
+    struct RowNumber {
+        unsigned long row_number = 0;
+
+        inline void update(const Row &row, Boundary boundary) {
+            row_number = boundary == NEW_PARTITION ? 1 : row_number + 1;
+        }
+
+        inline void write(Row &row) const {
+            row.columns[OUT] = row_number;
+        }
+    };
+
+    template<int OUT>
+    struct Rank {
+        unsigned long row_number = 0;
+        unsigned long rank = 0;
+
+        inline void update(const Row &row, Boundary boundary) {
+            row_number = boundary == NEW_PARTITION ? 1 : row_number + 1;
+            if (boundary != PEER) {
+                rank = row_number;
+            }
+        }
+
+        inline void write(Row &row) const {
+            row.columns[OUT] = rank;
+        }
+    };
+
+    template<int OUT>
+    struct DenseRank {
+        unsigned long rank = 0;
+
+        inline void update(const Row &row, Boundary boundary) {
+            if (boundary == NEW_PARTITION) {
+                rank = 1;
+            } else if (boundary == NEW_PEER_GROUP) {
+                rank++;
+            }
+        }
+
+        inline void write(Row &row) const {
+            row.columns[OUT] = rank;
+        }
+    };
+
+    /**
+     * Cumulative aggregate over the rows of the partition up to and including the current row (a ROWS frame),
+     * Part is one of the parts of aggregates::Aggregates, e.g. aggregates::fused::Sum<3>.
+     */
+    template<typename Part, int OUT>
+    struct Running {
+        unsigned long state[Part::WIDTH] = {};
+
+        inline void update(const Row &row, Boundary boundary) {
+            if (boundary == NEW_PARTITION) {
+                Part::init(state, Part::input(row));
+            } else {
+                unsigned long tmp[Part::WIDTH];
+                Part::init(tmp, Part::input(row));
+                Part::merge(state, tmp);
+            }
+        }
+
+        inline void write(Row &row) const {
+            unsigned long tmp[Part::WIDTH];
+            memcpy(tmp, state, sizeof tmp);
+            Part::finalize(tmp);
+            row.columns[OUT] = tmp[0];
+        }
+    };
+}
+
+namespace ovc::iterators {
+
+    /**
+     * Computes window functions over an input that is sorted on its first `partition_columns + order_columns`
+     * columns. Every input row is returned with the results of the window functions written to their output
+     * columns, which should lie outside of the sort key. With USE_OVC, partition boundaries and peer groups are
+     * detected from the offsets of the rows' offset-value codes (w.r.t. the sort key) instead of comparing columns.
+     */
+    template<bool USE_OVC, typename... Functions>
+    class WindowBase : public UnaryIterator {
+    public:
+        WindowBase(Iterator *input, int partition_columns, int order_columns)
+                : UnaryIterator(input), partition_columns(partition_columns),
+                  key_columns(partition_columns + order_columns), first(true), prev(), out(), count(0) {
+        }
+
+        void open() override {
+            Iterator::open();
+            input->open();
+            first = true;
+        }
+
+        Row *next() override {
+            Iterator::next();
+            Row *row = input->next();
+            if (row == nullptr) {
+                return nullptr;
+            }
+
+            window::Boundary boundary = classify(*row);
+            std::apply([row, boundary](auto &...f) { (f.update(*row, boundary), ...); }, functions);
+            out = *row;
+            input->free();
+            std::apply([this](const auto &...f) { (f.write(out), ...); }, functions);
+
+            count++;
+            return &out;
+        }
+
+        void close() override {
+            Iterator::close();
+            input->close();
+        }
+
+        unsigned long getCount() const {
+            return count;
+        }
+
+    private:
+        std::tuple<Functions...> functions;
+        int partition_columns;
+        int key_columns;
+        bool first;
+        Row prev;
+        Row out;
+        unsigned long count;
+
+        inline window::Boundary classify(const Row &row) {
+            if (first) {
+                first = false;
+                if constexpr (!USE_OVC) {
+                    prev = row;
+                }
+                return window::NEW_PARTITION;
+            }
+
+            if constexpr (USE_OVC) {
+                unsigned long offset = row.getOffset();
+                if (offset < partition_columns) {
+                    return window::NEW_PARTITION;
+                }
+                return offset < key_columns ? window::NEW_PEER_GROUP : window::PEER;
+            } else {
+                int i = 0;
+                for (; i < key_columns; i++) {
+                    stats.column_comparisons++;
+                    if (row.columns[i] != prev.columns[i]) {
+                        break;
+                    }
+                }
+                if (i < key_columns) {
+                    memcpy(prev.columns + i, row.columns + i, (key_columns - i) * sizeof row.columns[0]);
+                }
+                if (i < partition_columns) {
+                    return window::NEW_PARTITION;
+                }
+                return i < key_columns ? window::NEW_PEER_GROUP : window::PEER;
+            }
+        }
+    };
+
+    template<typename... Functions>
+    class WindowOVC : public WindowBase<true, Functions...> {
+    public:
+        WindowOVC(Iterator *input, int partition_columns, int order_columns)
+                : WindowBase<true, Functions...>(input, partition_columns, order_columns) {}
+    };
+
+    template<typename... Functions>
+    class Window : public WindowBase<false, Functions...> {
+    public:
+        Window(Iterator *input, int partition_columns, int order_columns)
+                : WindowBase<false, Functions...>(input, partition_columns, order_columns) {}
+    };
+}
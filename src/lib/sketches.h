@@ -0,0 +1,225 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "Row.h"
+
+/**
+ * Mergeable sketches as parts of composite aggregates (see aggregates::Aggregates). Their state is kept in the
+ * spare columns of the row, so they merge wherever the exact aggregates do, e.g. during early aggregation in the
+ * Sorter and in Partitioner::putEarlyAggregate.
+ */
+namespace ovc::aggregates::fused {
+
+    /**
+     * HyperLogLog estimate of COUNT(DISTINCT columns[COLUMN]) with one byte register per byte of state, i.e.
+     * 8 * COLUMNS registers. The standard error is about 1.04 / sqrt(8 * COLUMNS), 9% for the default of 16 columns.
+     * After finalize, the first column holds the estimate, the others are zero.
+     */
+    template<int COLUMN, int COLUMNS = 16>
+    struct CountDistinct {
+        static_assert(COLUMNS >= 2, "too few registers");
+
+        static constexpr int WIDTH = COLUMNS;
+        static constexpr int NUM_REGISTERS = 8 * COLUMNS;
+
+        static inline unsigned long input(const Row &row) {
+            return row.columns[COLUMN];
+        }
+
+        static inline void init(unsigned long *state, unsigned long value) {
+            memset(state, 0, WIDTH * sizeof *state);
+            uint64_t hash = mix(value);
+            // the high half selects the register, the rank is taken from the low half
+            auto index = ((hash >> 32) * NUM_REGISTERS) >> 32;
+            auto rest = (uint32_t) hash;
+            registers(state)[index] = rest ? __builtin_clz(rest) + 1 : 33;
+        }
+
+        static inline void merge(unsigned long *acc, const unsigned long *state) {
+            uint8_t *a = registers(acc);
+            const uint8_t *r = registers(state);
+            for (int i = 0; i < NUM_REGISTERS; i++) {
+                a[i] = a[i] < r[i] ? r[i] : a[i];
+            }
+        }
+
+        static inline void finalize(unsigned long *state) {
+            unsigned long count = estimate(state);
+            memset(state, 0, WIDTH * sizeof *state);
+            state[0] = count;
+        }
+
+        static unsigned long estimate(const unsigned long *state) {
+            const uint8_t *r = registers(state);
+            double sum = 0;
+            int zeros = 0;
+            for (int i = 0; i < NUM_REGISTERS; i++) {
+                sum += std::ldexp(1.0, -r[i]);
+                zeros += r[i] == 0;
+            }
+            double m = NUM_REGISTERS;
+            double e = alpha() * m * m / sum;
+            if (e <= 2.5 * m && zeros > 0) {
+                // linear counting for small cardinalities
+                e = m * std::log(m / zeros);
+            }
+            return std::llround(e);
+        }
+
+    private:
+        static constexpr double alpha() {
+            return NUM_REGISTERS <= 16 ? 0.673
+                                       : NUM_REGISTERS <= 32 ? 0.697
+                                                             : NUM_REGISTERS <= 64 ? 0.709
+                                                                                   : 0.7213 / (1 + 1.079 / NUM_REGISTERS);
+        }
+
+        /**
+         * murmur3 finalizer, column values are often small and dense.
+         */
+        static inline uint64_t mix(uint64_t h) {
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdul;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ul;
+            h ^= h >> 33;
+            return h;
+        }
+
+        static inline uint8_t *registers(unsigned long *state) {
+            return reinterpret_cast<uint8_t *>(state);
+        }
+
+        static inline const uint8_t *registers(const unsigned long *state) {
+            return reinterpret_cast<const uint8_t *>(state);
+        }
+    };
+
+    /**
+     * Estimate of the PERCENT-th percentile of columns[COLUMN]. Values are counted in log-linear buckets with
+     * 2^SUB_BITS buckets per power of two (relative error below 2^-(SUB_BITS+1)), in a window of 2 * (COLUMNS - 1)
+     * consecutive buckets. If the values of a group span more buckets, the lowest buckets are collapsed into the
+     * lowest bucket of the window, so high percentiles stay accurate. Counters have 32 bits.
+     * After finalize, the first column holds the estimate, the others are zero.
+     */
+    template<int COLUMN, int PERCENT, int COLUMNS = 16, int SUB_BITS = 2>
+    struct Quantile {
+        static_assert(0 <= PERCENT && PERCENT <= 100, "not a percentile");
+        static_assert(COLUMNS >= 2, "too few counters");
+
+        static constexpr int WIDTH = COLUMNS;
+        static constexpr int NUM_COUNTERS = 2 * (COLUMNS - 1);
+        static constexpr unsigned long SUB_BUCKETS = 1ul << SUB_BITS;
+
+        static inline unsigned long input(const Row &row) {
+            return row.columns[COLUMN];
+        }
+
+        /**
+         * The first column holds the bucket of the first counter, the others hold the counters.
+         */
+        static inline void init(unsigned long *state, unsigned long value) {
+            memset(state, 0, WIDTH * sizeof *state);
+            state[0] = bucket(value);
+            uint32_t one = 1;
+            memcpy(state + 1, &one, sizeof one);
+        }
+
+        static void merge(unsigned long *acc, const unsigned long *state) {
+            uint32_t a[NUM_COUNTERS];
+            uint32_t s[NUM_COUNTERS];
+            memcpy(a, acc + 1, sizeof a);
+            memcpy(s, state + 1, sizeof s);
+
+            unsigned long lo = std::min(acc[0] + lowest(a), state[0] + lowest(s));
+            unsigned long hi = std::max(acc[0] + highest(a), state[0] + highest(s));
+            unsigned long base = hi - lo < NUM_COUNTERS ? lo : hi - (NUM_COUNTERS - 1);
+
+            uint32_t res[NUM_COUNTERS] = {};
+            add(res, base, a, acc[0]);
+            add(res, base, s, state[0]);
+
+            acc[0] = base;
+            memcpy(acc + 1, res, sizeof res);
+        }
+
+        static inline void finalize(unsigned long *state) {
+            unsigned long value = estimate(state, PERCENT / 100.0);
+            memset(state, 0, WIDTH * sizeof *state);
+            state[0] = value;
+        }
+
+        static unsigned long estimate(const unsigned long *state, double q) {
+            uint32_t c[NUM_COUNTERS];
+            memcpy(c, state + 1, sizeof c);
+            unsigned long total = 0;
+            for (uint32_t n: c) {
+                total += n;
+            }
+            auto rank = (unsigned long) (q * (total - 1));
+            unsigned long seen = 0;
+            int i = 0;
+            for (; i < NUM_COUNTERS - 1; i++) {
+                seen += c[i];
+                if (seen > rank) {
+                    break;
+                }
+            }
+            return representative(state[0] + i);
+        }
+
+        /**
+         * Values below 2 * SUB_BUCKETS have their own bucket, larger values are bucketed by their highest
+         * SUB_BITS + 1 bits.
+         */
+        static inline unsigned long bucket(unsigned long value) {
+            if (value < 2 * SUB_BUCKETS) {
+                return value;
+            }
+            int shift = 63 - __builtin_clzl(value) - SUB_BITS;
+            return shift * SUB_BUCKETS + (value >> shift);
+        }
+
+        /**
+         * The middle of the value range of a bucket.
+         */
+        static inline unsigned long representative(unsigned long bucket) {
+            if (bucket < 2 * SUB_BUCKETS) {
+                return bucket;
+            }
+            int shift = (int) (bucket / SUB_BUCKETS) - 1;
+            unsigned long mantissa = bucket % SUB_BUCKETS + SUB_BUCKETS;
+            unsigned long lower = mantissa << shift;
+            return lower + (((1ul << shift) - 1) >> 1);
+        }
+
+    private:
+        static inline unsigned long lowest(const uint32_t *c) {
+            int i = 0;
+            while (i < NUM_COUNTERS - 1 && c[i] == 0) {
+                i++;
+            }
+            return i;
+        }
+
+        static inline unsigned long highest(const uint32_t *c) {
+            int i = NUM_COUNTERS - 1;
+            while (i > 0 && c[i] == 0) {
+                i--;
+            }
+            return i;
+        }
+
+        static inline void add(uint32_t *res, unsigned long base, const uint32_t *c, unsigned long c_base) {
+            for (int i = 0; i < NUM_COUNTERS; i++) {
+                if (c[i]) {
+                    unsigned long b = c_base + i;
+                    res[b < base ? 0 : b - base] += c[i];
+                }
+            }
+        }
+    };
+}
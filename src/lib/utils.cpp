@@ -1,6 +1,10 @@
 #include "utils.h"
 #include "defs.h"
+#include "log.h"
 
+#include <cerrno>
+#include <cstring>
+#include <sys/resource.h>
 #include <unistd.h>
 
 namespace ovc {
@@ -10,4 +14,26 @@ namespace ovc {
         return std::string(BASEDIR "/ovc." + std::to_string(pid) + "." + std::to_string(i++) + ".dat");
     }
 
+    size_t max_open_files() {
+        rlimit limit = {};
+        if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+            return 1024;
+        }
+        return limit.rlim_cur;
+    }
+
+    void raise_open_files_limit() {
+        rlimit limit = {};
+        if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+            log_warn("getrlimit failed: %s", strerror(errno));
+            return;
+        }
+        if (limit.rlim_cur < limit.rlim_max) {
+            limit.rlim_cur = limit.rlim_max;
+            if (setrlimit(RLIMIT_NOFILE, &limit) != 0) {
+                log_warn("setrlimit failed: %s", strerror(errno));
+            }
+        }
+    }
+
 };
\ No newline at end of file
@@ -6,6 +6,17 @@
 namespace ovc {
     std::string generate_path();
 
+    /**
+     * The number of files the process may currently open (the soft limit).
+     */
+    size_t max_open_files();
+
+    /**
+     * Raise the soft limit on open files to the hard limit, which allows sorts to merge more runs at once. Meant to be
+     * called by the main program, the library never changes process limits on its own.
+     */
+    void raise_open_files_limit();
+
     template<
             class result_t   = std::chrono::milliseconds,
             class clock_t    = std::chrono::steady_clock,
@@ -14,6 +14,7 @@
 #include "lib/iterators/UniqueRowGenerator.h"
 #include "lib/comparators.h"
 #include "lib/iterators/InSortGroupBy.h"
+#include "lib/PriorityQueue.h"
 
 #include <vector>
 
@@ -462,6 +463,106 @@ void experiment_column_order_sort() {
     fclose(results);
 }
 
+/**
+ * Sort a batch of rows with a single tree-of-losers, returns the duration.
+ */
+template<bool PACKED, typename Compare>
+unsigned long sort_with_queue(std::vector<Row> rows, const Compare &cmp, iterator_stats &stats) {
+    auto t0 = now();
+    PriorityQueue<Compare, PACKED> queue(p2(rows.size()), &stats, cmp);
+    for (auto &row: rows) {
+        if constexpr (Compare::USES_OVC) {
+            row.key = cmp.makeOVC(ROW_ARITY, 0, &row);
+        }
+        queue.push(&row, INITIAL_RUN_IDX);
+    }
+    queue.flush_sentinels();
+    unsigned long sum = 0;
+    while (!queue.isEmpty()) {
+        sum += queue.popf()->columns[ROW_ARITY - 1];
+    }
+    auto duration = since(t0);
+    // keep the pops from being optimized away
+    stats.rows_read += sum & 1;
+    return duration;
+}
+
+/**
+ * Microbenchmark of the node layouts of the priority queue: plain nodes compare ties on the rows, packed nodes on
+ * the cached column first. Rows share a zero prefix, followed by columns with `bits` bits each.
+ */
+void experiment_queue_layout() {
+    int num_experiments = 5;
+
+    FILE *results = fopen("queue_layout.csv", "w");
+    fprintf(results, "experiment,num_rows,zero_prefix,bits,column_comparisons,duration\n");
+
+    for (int log_rows = 10; log_rows <= 18; log_rows += 2) {
+        size_t num_rows = 1ul << log_rows;
+        for (int zero_prefix: {0, 4, 8}) {
+            for (int bits: {2, 8, 16}) {
+                uint8_t column_bits[ROW_ARITY] = {0};
+                for (int i = zero_prefix; i < ROW_ARITY; i++) {
+                    column_bits[i] = bits;
+                }
+                auto rows = RowGenerator(num_rows, column_bits, 1337).collect();
+
+                for (int i = 0; i < num_experiments; i++) {
+                    iterator_stats stats[4] = {};
+                    unsigned long durations[4] = {
+                            sort_with_queue<false>(rows, Cmp(&stats[0]), stats[0]),
+                            sort_with_queue<true>(rows, Cmp(&stats[1]), stats[1]),
+                            sort_with_queue<false>(rows, CmpOVC(&stats[2]), stats[2]),
+                            sort_with_queue<true>(rows, CmpOVC(&stats[3]), stats[3]),
+                    };
+                    const char *names[4] = {"no_ovc", "no_ovc_packed", "ovc", "ovc_packed"};
+                    for (int j = 0; j < 4; j++) {
+                        fprintf(results, "%s,%lu,%d,%d,%lu,%lu\n", names[j], num_rows, zero_prefix, bits,
+                                stats[j].column_comparisons, durations[j]);
+                    }
+                    fflush(results);
+                }
+            }
+        }
+    }
+    fclose(results);
+}
+
+/**
+ * Run generation with and without MSD radix partitioning on the leading column, whose domain grows with `bits`.
+ */
+void experiment_radix_sort() {
+    size_t num_rows = 1 << 22;
+    int num_experiments = 5;
+
+    FILE *results = fopen("radix_sort.csv", "w");
+    fprintf(results, "experiment,num_rows,bits,column_comparisons,duration\n");
+
+    for (uint8_t bits: {4, 8, 16, 32, 48}) {
+        auto gen = RowGenerator(num_rows, {bits, 8, 8, 8}, 1337);
+
+        for (int i = 0; i < num_experiments; i++) {
+            Iterator *plans[4] = {
+                    new SortOVC(gen.clone()),
+                    (new SortOVC(gen.clone()))->radixPartitioning(),
+                    new Sort(gen.clone()),
+                    (new Sort(gen.clone()))->radixPartitioning(),
+            };
+            const char *names[4] = {"ovc", "ovc_radix", "no_ovc", "no_ovc_radix"};
+            for (int j = 0; j < 4; j++) {
+                auto t0 = now();
+                plans[j]->run();
+                auto duration = since(t0);
+                fprintf(results, "%s,%lu,%d,%lu,%lu\n", names[j], num_rows, bits,
+                        plans[j]->getStats().column_comparisons, duration);
+                fflush(results);
+                delete plans[j];
+            }
+        }
+    }
+    fclose(results);
+}
+
 void experiment_complex() {
     int num_rows = 1 << 20;
     int sort_columns = ROW_ARITY;
@@ -1024,6 +1125,8 @@ int main(int argc, char *argv[]) {
     log_set_quiet(false);
     log_set_level(LOG_TRACE);
     log_info("start");
+    // merging thousands of runs at once needs a descriptor per run
+    raise_open_files_limit();
 
     auto start = now();
 
@@ -1032,6 +1135,8 @@ int main(int argc, char *argv[]) {
     experiment_joins5();
     experiment_column_order_sort();
 
+    //experiment_queue_layout();
+    //experiment_radix_sort();
     //experiment_complex();
     //experiment_complex2();
     //experiment_complex3();
@@ -316,16 +316,87 @@ void experiment_sort_order2() {
     fclose(results);
 }
 
+void experiment_segmented_parallel() {
+    printf("experiment_segmented_parallel\n");
+
+    const char *result_path = "segmented_parallel.csv";
+
+    int num_rows = 1 << 20;
+    int reps = 10;
+
+#ifndef NDEBUG
+    reps = 1;
+#endif
+#ifdef COLLECT_STATS
+    result_path = "segmented_parallel_stats.csv";
+    reps = 1;
+#endif
+
+    FILE *results = fopen(result_path, "w");
+    fprintf(results, "experiment,num_rows,bits_a,num_threads,segments_found,runs_"
+                     "generated,column_comparisons,duration\n");
+
+    uint8_t ABC[ROW_ARITY] = {0, 1, 2};
+    uint8_t ACB[ROW_ARITY] = {0, 2, 1};
+
+    size_t max_threads = std::thread::hardware_concurrency();
+
+    // from few large segments to many small ones, sorted by one thread and by growing pools
+    for (uint64_t bitsA = 2; bitsA <= 16; bitsA += 2) {
+        printf("bitsA=%lu\n", bitsA);
+
+        auto gen = VectorGen(new SortPrefixOVC(
+                new GeneratorWithDomains(num_rows, {1ul << bitsA, 1 << 4, 1 << 16}, 1337), 3));
+
+        for (size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+            for (int i = 0; i < reps; i++) {
+                auto ovc = new SegmentedSortOVC<2048>(gen.clone(), ABC, 1, 1, 1);
+                if (num_threads > 1) {
+                    ovc->parallel(num_threads);
+                }
+
+                Iterator *plan = ovc;
+#ifndef NDEBUG
+                auto asserter = new AssertSorted(plan, CmpColumnListOVC(ACB, 3));
+                plan = asserter;
+#endif
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                auto t0 = now();
+                plan->run();
+                auto duration = since(t0);
+
+#ifndef NDEBUG
+                assert(asserter->getCount() == num_rows);
+                assert(asserter->isSorted());
+#endif
+
+                fprintf(results, "%s,%d,%lu,%lu,%lu,%lu,%lu,%lu\n", "ovc", num_rows, bitsA,
+                        num_threads, ovc->getStats().segments_found, ovc->getStats().runs_generated,
+                        ovc->getStats().column_comparisons, duration);
+                fflush(results);
+
+                delete plan;
+            }
+        }
+    }
+
+    fclose(results);
+}
+
 int main(int argc, char *argv[]) {
     log_open(LOG_TRACE);
     log_set_quiet(false);
     log_set_level(LOG_TRACE);
     log_info("start");
+    // merging thousands of runs at once needs a descriptor per run
+    raise_open_files_limit();
 
     auto start = now();
 
     experiment_sort_order1();
     experiment_sort_order2();
+    experiment_segmented_parallel();
 
     log_info("elapsed=%lums", since(start));
     log_info("fin");